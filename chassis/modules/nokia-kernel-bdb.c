@@ -199,6 +199,7 @@ MODULE_PARM_DESC(nokia_debug,"Set debug level (default 0)");
 
 
 #include <linux/mutex.h>
+#include <linux/bitops.h>
 
 #define NOKIA_DEV_NAME                      "nokia-bdb"
 
@@ -321,10 +322,135 @@ static uint32 bdb_read_flushes, bdb_write_flushes, bdb_sac_write_fail, bdb_fifo_
 static uint32 bdb_write_retries, bdb_write_retry_failures, bdb_read_retries, bdb_read_retry_failures;
 static uint32 max_retries = 3, max_wait_time;
 
+module_param(max_retries, uint, 0644);
+MODULE_PARM_DESC(max_retries,"BDB read/write attempts per access (default 3)");
+
+/*
+ * Adaptive completion timeouts: each slot keeps a log2 histogram of its
+ * completion latency, halved every BDB_LAT_WINDOW samples so it follows the
+ * card. The slot's timeout is its bdb_timeout_pct per mille latency times
+ * bdb_timeout_factor, clamped to [bdb_timeout_min_us, bdb_timeout_max_us].
+ * After a timeout the slot's retries wait at least BDB_TIMEOUT, doubling up
+ * to bdb_timeout_max_us, until the next completion: a genuinely slow access
+ * still gets the time it used to. BDB_TIMEOUT is used until a slot has
+ * BDB_LAT_MIN_SAMPLES samples. The floor defaults to BDB_TIMEOUT until
+ * shorter timeouts have been measured on hardware.
+ */
+#define BDB_LAT_BUCKETS                     32
+#define BDB_LAT_WINDOW                      1024
+#define BDB_LAT_MIN_SAMPLES                 32
+#define BDB_LAT_UPDATE                      16
+/* bounds the shift only, bdb_timeout_max_us bounds the timeout */
+#define BDB_LAT_MAX_BACKOFF                 16
+
+static uint bdb_timeout_min_us = BDB_TIMEOUT/1000;
+module_param(bdb_timeout_min_us, uint, 0644);
+MODULE_PARM_DESC(bdb_timeout_min_us,"Minimum BDB completion timeout in us (default 25000)");
+
+static uint bdb_timeout_max_us = 100000;
+module_param(bdb_timeout_max_us, uint, 0644);
+MODULE_PARM_DESC(bdb_timeout_max_us,"Maximum BDB completion timeout in us (default 100000)");
+
+static uint bdb_timeout_pct = 999;
+module_param(bdb_timeout_pct, uint, 0644);
+MODULE_PARM_DESC(bdb_timeout_pct,"BDB latency percentile in per mille the timeout is based on (default 999)");
+
+static uint bdb_timeout_factor = 4;
+module_param(bdb_timeout_factor, uint, 0644);
+MODULE_PARM_DESC(bdb_timeout_factor,"BDB timeout safety factor over the latency percentile (default 4)");
+
+struct bdb_slot_lat
+{
+    uint32 hist[BDB_LAT_BUCKETS];   /* bucket b: latency < 2^b ns */
+    uint32 samples;                 /* in hist */
+    uint32 completions, timeouts;
+    uint32 backoff;
+    uint64 pct_ns, timeout_ns, max_ns;
+};
+
+static struct bdb_slot_lat bdb_lat[MAX_HWSLOT+1];
+
 
 static DEFINE_MUTEX(bdb_lock);
 static struct mutex bdb_slot_lock[MAX_HWSLOT+1];
 
+static uint64 bdbSlotTimeout(int hwSlot)
+{
+    struct bdb_slot_lat *lat = &bdb_lat[hwSlot];
+    uint64 min_ns = bdb_timeout_min_us*1000ULL;
+    uint64 max_ns = bdb_timeout_max_us*1000ULL;
+    uint64 timeout = lat->timeout_ns ? lat->timeout_ns : BDB_TIMEOUT;
+
+    if (lat->backoff)
+    {
+        /* retrying after a timeout */
+        timeout <<= lat->backoff;
+        if (timeout < BDB_TIMEOUT)
+            timeout = BDB_TIMEOUT;
+    }
+    if (timeout < min_ns)
+        timeout = min_ns;
+    if (timeout > max_ns)
+        timeout = max_ns;
+    return timeout;
+}
+
+static void bdbSlotLatencyUpdate(struct bdb_slot_lat *lat)
+{
+    uint32 want = (uint32)(((uint64)lat->samples * min(bdb_timeout_pct, 1000U) + 999) / 1000);
+    uint32 sum = 0;
+    int b;
+
+    for (b = 0; b < BDB_LAT_BUCKETS-1; b++)
+    {
+        sum += lat->hist[b];
+        if (sum >= want)
+            break;
+    }
+    lat->pct_ns = 1ULL << b;
+    lat->timeout_ns = lat->pct_ns * max(bdb_timeout_factor, 1U);
+}
+
+static void bdbSlotLatency(int hwSlot, uint64 ns)
+{
+    struct bdb_slot_lat *lat = &bdb_lat[hwSlot];
+    int b;
+
+    lat->hist[min(fls64(ns), BDB_LAT_BUCKETS-1)]++;
+    lat->samples++;
+    lat->completions++;
+    lat->backoff = 0;
+    if (lat->max_ns < ns)
+        lat->max_ns = ns;
+
+    if (lat->samples >= BDB_LAT_WINDOW)
+    {
+        lat->samples = 0;
+        for (b = 0; b < BDB_LAT_BUCKETS; b++)
+        {
+            lat->hist[b] /= 2;
+            lat->samples += lat->hist[b];
+        }
+    }
+
+    if (lat->samples >= BDB_LAT_MIN_SAMPLES && (lat->completions % BDB_LAT_UPDATE) == 0)
+        bdbSlotLatencyUpdate(lat);
+}
+
+static void bdbSlotTimedOut(int hwSlot, uint64 ns)
+{
+    struct bdb_slot_lat *lat = &bdb_lat[hwSlot];
+
+    /* the latency is at least ns, count it so the estimate moves up */
+    lat->hist[min(fls64(ns), BDB_LAT_BUCKETS-1)]++;
+    lat->samples++;
+    lat->timeouts++;
+    if (lat->backoff < BDB_LAT_MAX_BACKOFF)
+        lat->backoff++;
+    if (lat->samples >= BDB_LAT_MIN_SAMPLES)
+        bdbSlotLatencyUpdate(lat);
+}
+
 static void nokia_dump(struct seq_file *m)
 {
     int idx;
@@ -336,6 +462,16 @@ static void nokia_dump(struct seq_file *m)
     seq_printf(m, " fifo_wait:  %6u  ack flush:   %6u  sac_write:  %6u  max_wait:   %u us\n", bdb_fifo_depth_wait, bdb_spurious_ack, bdb_sac_write_fail, max_wait_time/1000);
     seq_printf(m, " read_fail:  %6u  read_flush:  %6u  read_retry: %4u  retry_fail: %u\n", bdb_read_fail,  bdb_read_flushes,  bdb_read_retries,  bdb_read_retry_failures);
     seq_printf(m, " write_fail: %6u  write_flush: %6u  write_retry:%4u  retry_fail: %u\n", bdb_write_fail, bdb_write_flushes, bdb_write_retries, bdb_write_retry_failures);
+    seq_printf(m, " timeout: min %u us max %u us pct %u/1000 factor %u retries %u (default %llu us)\n", bdb_timeout_min_us, bdb_timeout_max_us, bdb_timeout_pct, bdb_timeout_factor, max_retries, BDB_TIMEOUT/1000);
+
+    for (idx = 0; idx <= MAX_HWSLOT; idx++)
+    {
+        struct bdb_slot_lat *lat = &bdb_lat[idx];
+
+        if (lat->completions || lat->timeouts)
+            seq_printf(m, "\tslot %2d: completions %10u  timeouts %6u  pct %8lu ns  max %8lu us  timeout %6lu us  backoff %u\n",
+                       idx, lat->completions, lat->timeouts, lat->pct_ns, lat->max_ns/1000, bdbSlotTimeout(idx)/1000, lat->backoff);
+    }
 
     for (idx = 0; idx < MAX_NOKIA_RAMONS; idx++) 
     {
@@ -393,7 +529,7 @@ static int bdbWaitForResult(int hwSlot, int * flushes)
     uint32 ctrl, bdbSlot;
     uint64 nsecs = ktime_get_raw_ns();
     uint64 now = nsecs;
-    uint64 timeout = BDB_TIMEOUT;
+    uint64 timeout = bdbSlotTimeout(hwSlot);
     bool flushed = false;
 
     while (true)                                                   
@@ -406,8 +542,12 @@ static int bdbWaitForResult(int hwSlot, int * flushes)
 
         if ((ctrl & B_GEN_CONFIG_P_READ_DONE) && (hwSlot == bdbSlot))
         {
-            if (!flushed && max_wait_time < (old_now-nsecs))
-                max_wait_time = (old_now-nsecs);
+            if (!flushed)
+            {
+                if (max_wait_time < (old_now-nsecs))
+                    max_wait_time = (old_now-nsecs);
+                bdbSlotLatency(hwSlot, old_now-nsecs);
+            }
 
             return (ctrl & (B_GEN_CONFIG_RESP_ERROR|B_GEN_CONFIG_P_READ_ERR)) ? LUBDE_FAIL : LUBDE_SUCCESS;
         }
@@ -418,6 +558,9 @@ static int bdbWaitForResult(int hwSlot, int * flushes)
             continue;
         }
 
+        if (!flushed)
+            bdbSlotTimedOut(hwSlot, now-nsecs);
+
         if (!(ctrl & B_GEN_CONFIG_P_READ_DONE) || !bdb_parallel)
             break;
 
@@ -426,7 +569,7 @@ static int bdbWaitForResult(int hwSlot, int * flushes)
 
         read32(bdb_regs + BDB_POSTED_READ_REG_OFF);
 
-        timeout = 2*BDB_TIMEOUT;
+        timeout = 2*timeout;
     }
 
     return LUBDE_FAIL;
@@ -500,15 +643,16 @@ int bdbReadWordRaw(uint32 hwSlot, uint32 addr, int wsize, void * ret)
 
 int bdbReadWord(uint32 hwSlot, uint32 addr, int wsize, void * ret)
 {
-    int rc, retries = max_retries;
+    uint32 tries = max_retries ? max_retries : 1;
+    int rc, retries = tries;
 
     while (retries)
     {
         rc = bdbReadWordRaw(hwSlot, addr, wsize, ret);
         if (rc == 0)
         {
-            if (retries != max_retries)
-                printk(KWARN "Slot %d BDB read#%d retry SUCCESS addr %x data = %x\n", hwSlot, max_retries-retries+1, addr, *(uint32_t *)ret);
+            if (retries != tries)
+                printk(KWARN "Slot %d BDB read#%d retry SUCCESS addr %x data = %x\n", hwSlot, tries-retries+1, addr, *(uint32_t *)ret);
             return rc;
         }
         retries--;
@@ -597,7 +741,8 @@ int bdbWriteWordRaw(uint32 hwSlot, uint32 addr, int wsize, void * data)
 
 int bdbWriteWord(uint32 hwSlot, uint32 addr, int wsize, void * data)
 {
-    int rc, retries = max_retries;
+    uint32 tries = max_retries ? max_retries : 1;
+    int rc, retries = tries;
 
     while (retries)
     {
@@ -18,17 +18,104 @@
 #include <asm/io.h>
 #include <linux/pci.h>
 #include <linux/sizes.h>
+#include <linux/gpio/consumer.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/spinlock.h>
+
+/*
+ * The KICK AML method pulses a GPIO line. Evaluating it runs the AML
+ * interpreter under the ACPI global lock, so the kick can wait behind
+ * any other ACPI activity. With gpio_kick=1, and when the device's _CRS
+ * describes the line, it is pulsed directly and KICK is only the
+ * fallback. KICK stays the default until the direct pulse is qualified
+ * on every platform.
+ */
+static bool gpio_kick;
+module_param(gpio_kick, bool, 0444);
+MODULE_PARM_DESC(gpio_kick, "Kick through the _CRS GPIO instead of the KICK AML method");
+
+/*
+ * The pulse is busy-waited up to NOKIA_GPIO_WDT_UDELAY_MAX_US and slept
+ * above it; probe clamps it to NOKIA_GPIO_WDT_PULSE_MAX_US.
+ */
+#define NOKIA_GPIO_WDT_UDELAY_MAX_US	10
+#define NOKIA_GPIO_WDT_PULSE_MAX_US	1000
+
+static unsigned int kick_pulse_us = 1;
+module_param(kick_pulse_us, uint, 0444);
+MODULE_PARM_DESC(kick_pulse_us, "Width of the direct GPIO kick pulse in usecs (max 1000)");
 
 struct nokia_gpio_wdt_priv {
 	struct watchdog_device wdd;
+	struct gpio_desc *kick_gpio;
+	/* the first GpioIo of _CRS, with its polarity */
+	struct acpi_gpio_params kick_params;
+	struct acpi_gpio_mapping acpi_gpios[2];
+	spinlock_t stats_lock;
+	u64 kicks;
+	u64 failures;
+	u64 total_ns;
+	u64 min_ns;
+	u64 max_ns;
+	int last_error;
 };
 
+static int nokia_gpio_wdt_kick(struct nokia_gpio_wdt_priv *priv)
+{
+	acpi_status status;
+
+	if (priv->kick_gpio) {
+		gpiod_set_value_cansleep(priv->kick_gpio, 1);
+		if (kick_pulse_us <= NOKIA_GPIO_WDT_UDELAY_MAX_US)
+			udelay(kick_pulse_us);
+		else
+			usleep_range(kick_pulse_us, kick_pulse_us + kick_pulse_us / 4);
+		gpiod_set_value_cansleep(priv->kick_gpio, 0);
+		return 0;
+	}
+
+	status = acpi_evaluate_object(ACPI_HANDLE(priv->wdd.parent), "KICK", NULL, NULL);
+	if (ACPI_FAILURE(status)) {
+		dev_warn_ratelimited(priv->wdd.parent, "KICK evaluation failed: %s\n",
+		                     acpi_format_exception(status));
+		return -EIO;
+	}
+	return 0;
+}
+
+/*
+ * A failed kick is counted in kick_stats and returned as -EIO, which
+ * nokia-watchdog counts as a missed kick and keeps running.
+ */
 static int nokia_gpio_wdt_ping(struct watchdog_device *wdd)
 {
-	acpi_evaluate_object(ACPI_HANDLE(wdd->parent), "KICK", NULL, NULL);
+	struct nokia_gpio_wdt_priv *priv = watchdog_get_drvdata(wdd);
+	unsigned long flags;
+	ktime_t start;
+	u64 ns;
+	int ret;
 
-	dev_dbg(wdd->parent, "Watchdog kick\n");
-	return 0;
+	start = ktime_get();
+	ret = nokia_gpio_wdt_kick(priv);
+	ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	spin_lock_irqsave(&priv->stats_lock, flags);
+	priv->kicks++;
+	priv->total_ns += ns;
+	if (priv->kicks == 1 || ns < priv->min_ns)
+		priv->min_ns = ns;
+	if (ns > priv->max_ns)
+		priv->max_ns = ns;
+	if (ret) {
+		priv->failures++;
+		priv->last_error = ret;
+	}
+	spin_unlock_irqrestore(&priv->stats_lock, flags);
+
+	dev_dbg(wdd->parent, "Watchdog kick %llu ns ret %d\n", ns, ret);
+	return ret;
 }
 
 static int nokia_gpio_wdt_start(struct watchdog_device *wdd)
@@ -92,6 +179,62 @@ static struct notifier_block nokia_gpio_wdt_notifier = {
 	.notifier_call = nokia_gpio_wdt_notify_sys,
 };
 
+/* kick statistics, next to the watchdog core attributes in /sys/class/watchdog/watchdogN */
+static ssize_t kick_method_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct nokia_gpio_wdt_priv *priv = watchdog_get_drvdata(dev_get_drvdata(dev));
+
+	return sprintf(buf, "%s\n", priv->kick_gpio ? "gpio" : "acpi");
+}
+
+static ssize_t kick_stats_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct nokia_gpio_wdt_priv *priv = watchdog_get_drvdata(dev_get_drvdata(dev));
+	u64 kicks, failures, total_ns, min_ns, max_ns;
+	unsigned long flags;
+	int last_error;
+
+	spin_lock_irqsave(&priv->stats_lock, flags);
+	kicks = priv->kicks;
+	failures = priv->failures;
+	total_ns = priv->total_ns;
+	min_ns = priv->min_ns;
+	max_ns = priv->max_ns;
+	last_error = priv->last_error;
+	spin_unlock_irqrestore(&priv->stats_lock, flags);
+
+	return sprintf(buf, "kicks %llu\nfailures %llu\nlast_error %d\nmin_ns %llu\navg_ns %llu\nmax_ns %llu\n",
+	               kicks, failures, last_error, min_ns, kicks ? div64_u64(total_ns, kicks) : 0, max_ns);
+}
+
+/* any write clears the statistics */
+static ssize_t kick_stats_store(struct device *dev, struct device_attribute *attr,
+                                const char *buf, size_t count)
+{
+	struct nokia_gpio_wdt_priv *priv = watchdog_get_drvdata(dev_get_drvdata(dev));
+	unsigned long flags;
+
+	spin_lock_irqsave(&priv->stats_lock, flags);
+	priv->kicks = 0;
+	priv->failures = 0;
+	priv->total_ns = 0;
+	priv->min_ns = 0;
+	priv->max_ns = 0;
+	priv->last_error = 0;
+	spin_unlock_irqrestore(&priv->stats_lock, flags);
+	return count;
+}
+
+static DEVICE_ATTR(kick_method, S_IRUGO, kick_method_show, NULL);
+static DEVICE_ATTR(kick_stats, S_IRUGO | S_IWUSR, kick_stats_show, kick_stats_store);
+
+static struct attribute *nokia_gpio_wdt_attrs[] = {
+	&dev_attr_kick_method.attr,
+	&dev_attr_kick_stats.attr,
+	NULL
+};
+ATTRIBUTE_GROUPS(nokia_gpio_wdt);
+
 static const struct watchdog_info nokia_gpio_wdt_info = {
 	.identity = "Nokia GPIO Watchdog",
 };
@@ -103,6 +246,58 @@ static const struct watchdog_ops nokia_gpio_wdt_ops = {
 	.ping  = nokia_gpio_wdt_ping,
 };
 
+static int nokia_gpio_wdt_find_kick(struct acpi_resource *ares, void *data)
+{
+	struct acpi_resource_gpio *agpio;
+	int *polarity = data;
+
+	if (*polarity < 0 && acpi_gpio_get_io_resource(ares, &agpio))
+		*polarity = agpio->polarity;
+	/* only looking, nothing is added to the list */
+	return 1;
+}
+
+/*
+ * gpiolib takes a GpioIo's polarity from the driver's mapping, not from
+ * _CRS, so the mapping is built from the resource itself
+ */
+static int nokia_gpio_wdt_get_kick_gpio(struct platform_device *pdev, struct nokia_gpio_wdt_priv *priv)
+{
+	struct acpi_device *adev = ACPI_COMPANION(&pdev->dev);
+	LIST_HEAD(resources);
+	int polarity = -1;
+	int ret;
+
+	if (!adev)
+		return -ENODEV;
+	ret = acpi_dev_get_resources(adev, &resources, nokia_gpio_wdt_find_kick, &polarity);
+	if (ret < 0)
+		return ret;
+	acpi_dev_free_resource_list(&resources);
+	if (polarity < 0)
+		return -ENOENT;
+
+	priv->kick_params.crs_entry_index = 0;
+	priv->kick_params.line_index = 0;
+	priv->kick_params.active_low = polarity == ACPI_ACTIVE_LOW;
+	priv->acpi_gpios[0].name = "kick-gpios";
+	priv->acpi_gpios[0].data = &priv->kick_params;
+	priv->acpi_gpios[0].size = 1;
+
+	ret = devm_acpi_dev_add_driver_gpios(&pdev->dev, priv->acpi_gpios);
+	if (ret)
+		return ret;
+	/* GPIOD_OUT_LOW is the inactive level whatever the polarity */
+	priv->kick_gpio = devm_gpiod_get(&pdev->dev, "kick", GPIOD_OUT_LOW);
+	if (IS_ERR(priv->kick_gpio)) {
+		ret = PTR_ERR(priv->kick_gpio);
+		priv->kick_gpio = NULL;
+		return ret;
+	}
+	dev_info(&pdev->dev, "kick GPIO is active %s\n", priv->kick_params.active_low ? "low" : "high");
+	return 0;
+}
+
 static int nokia_gpio_wdt_probe(struct platform_device *pdev)
 {
 	struct nokia_gpio_wdt_priv *priv;
@@ -113,10 +308,29 @@ static int nokia_gpio_wdt_probe(struct platform_device *pdev)
 		return -ENOMEM;
 
 	platform_set_drvdata(pdev, priv);
+	spin_lock_init(&priv->stats_lock);
+
+	if (gpio_kick) {
+		if (kick_pulse_us > NOKIA_GPIO_WDT_PULSE_MAX_US) {
+			dev_warn(&pdev->dev, "kick_pulse_us %u clamped to %u\n",
+			         kick_pulse_us, NOKIA_GPIO_WDT_PULSE_MAX_US);
+			kick_pulse_us = NOKIA_GPIO_WDT_PULSE_MAX_US;
+		}
+		ret = nokia_gpio_wdt_get_kick_gpio(pdev, priv);
+		if (ret == -EPROBE_DEFER)
+			return -EPROBE_DEFER;
+		if (ret)
+			dev_warn(&pdev->dev, "kick GPIO unavailable (%d), using KICK method\n", ret);
+	}
+	if (!priv->kick_gpio && !acpi_has_method(ACPI_HANDLE(&pdev->dev), "KICK")) {
+		dev_err(&pdev->dev, "no kick GPIO and no KICK method\n");
+		return -ENODEV;
+	}
 
 	priv->wdd.parent = &pdev->dev;
 	priv->wdd.info   = &nokia_gpio_wdt_info;
 	priv->wdd.ops    = &nokia_gpio_wdt_ops;
+	priv->wdd.groups = nokia_gpio_wdt_groups;
 
     watchdog_set_drvdata(&priv->wdd, priv);
     watchdog_set_nowayout(&priv->wdd, WATCHDOG_NOWAYOUT);
@@ -125,7 +339,10 @@ static int nokia_gpio_wdt_probe(struct platform_device *pdev)
 	if (ret)
 		return ret;
 
-	dev_info(&pdev->dev, "Watchdog enabled\n");
+	if (priv->kick_gpio)
+		dev_info(&pdev->dev, "Watchdog enabled, kick through GPIO %d\n", desc_to_gpio(priv->kick_gpio));
+	else
+		dev_info(&pdev->dev, "Watchdog enabled, kick through KICK method\n");
 	return 0;
 }
 
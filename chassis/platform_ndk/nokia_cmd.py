@@ -8,13 +8,20 @@
 #
 
 import argparse
+import contextlib
+import io
 import json
 from google.protobuf.json_format import MessageToJson
+import shlex
+import signal
 import subprocess
+import sys
 import time
 import os
 
 from platform_ndk import nokia_common
+from platform_ndk import nokia_mdipc_stats
+from platform_ndk import nokia_inventory
 from platform_ndk import platform_ndk_pb2
 from sonic_py_common.logger import Logger
 
@@ -76,6 +83,32 @@ qfpga_cli_port_name_dict = {
     "Port3": "qfpgap1/eth0",
 }
 
+# nokia_cmd collect sections: output file base name and the show commands
+# written to it. Each section also gets a .json file with the json-format
+# output of the commands that support it.
+COLLECT_SECTIONS = {
+    'general': ('ndk.general', [['show', 'ndk-version'], ['show', 'ndk-status'],
+                                ['show', 'platform'], ['show', 'firmware']]),
+    'power': ('ndk.power', [['show', 'power']]),
+    'syseeprom': ('ndk.eeprom', [['show', 'syseeprom']]),
+    'ndk-eeprom': ('ndk.ndk_eeprom', [['show', 'ndk-eeprom']]),
+    'sensors': ('ndk.sensors', [['show', 'sensors']]),
+    'asic-temperature': ('ndk.asic_temperature', [['show', 'asic-temperature']]),
+    'psus': ('ndk.psus', [['show', 'psus']]),
+    'system-leds': ('ndk.system_leds', [['show', 'system-leds']]),
+    'sfp': ('ndk.sfp', [['show', 'fp-status']]),
+    'mdipc': ('ndk.mdipc_stats', [['show', 'mdipc-stats']]),
+    'midplane': ('ndk.midplane', [['show', 'midplane', 'port-status'], ['show', 'midplane', 'port-counters'],
+                                  ['show', 'midplane', 'vlan-table'], ['show', 'midplane', 'mac-table'],
+                                  ['show', 'midplane', 'link-status-flap']]),
+    'sfm': ('ndk.sfm', [['show', 'sfm-summary'], ['show', 'sfm-eeprom']]),
+    'qfpga': ('qfpgamgr.admintech', [['show', 'qfpga', 'version'], ['show', 'qfpga', 'port-status'],
+                                     ['show', 'qfpga', 'vlan-counters'], ['show', 'qfpga', 'port-statistics'],
+                                     ['show', 'qfpga', 'error-counters']]),
+}
+COLLECT_NO_JSON = [['show', 'ndk-version']]
+COLLECT_DEFAULT_TIMEOUT = 300
+
 qfpga_ndk_port_name_dict = {
     "ALL_PORTS": "ALL_PORTS",
     "cpm-A": "cpma",
@@ -1190,17 +1223,27 @@ def set_log_restore_default():
     nokia_common.channel_shutdown(channel)
 
 def set_asic_temp(name, temp, threshold):
+    set_asic_temps([(name, temp, threshold)])
+
+def set_asic_temps(devices):
+    """
+    Push a list of (name, temp, threshold) asic temp-devices with a single
+    SetThermalAsicInfo
+    """
     channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_THERMAL_SERVICE)
     if not channel or not stub:
-        return
+        return False
 
-    asic_temp_entry = platform_ndk_pb2.AsicTempPb.AsicTempDevicePb(name=name, current_temp=temp,
-                                                                   threshold=threshold)
     asic_devices = []
-    asic_devices.append(asic_temp_entry)
+    for name, temp, threshold in devices:
+        asic_temp_entry = platform_ndk_pb2.AsicTempPb.AsicTempDevicePb(name=name, current_temp=temp,
+                                                                       threshold=threshold)
+        asic_devices.append(asic_temp_entry)
     asic_temp_all = platform_ndk_pb2.AsicTempPb(temp_device=asic_devices)
-    stub.SetThermalAsicInfo(platform_ndk_pb2.ReqTempParamsPb(asic_temp=asic_temp_all))
+    ret, response = nokia_common.try_grpc(stub.SetThermalAsicInfo,
+                                          platform_ndk_pb2.ReqTempParamsPb(asic_temp=asic_temp_all))
     nokia_common.channel_shutdown(channel)
+    return ret
 
 def modify_startup_debug(key_str, new_stringval):
     startup_debug="/etc/opt/srlinux/startup_debug.json"
@@ -1307,6 +1350,154 @@ def show_asic_temperature():
     print_table(field, dram_list)
     return
 
+def show_mdipc_stats():
+    snapshot = nokia_mdipc_stats.collect()
+    if len(snapshot.processes) == 0:
+        print('MDIPC statistics not available on this card')
+        return
+
+    ops = []
+    for op in range(len(nokia_mdipc_stats.STAT_OP_NAMES)):
+        for pclass in range(len(nokia_mdipc_stats.PAGE_CLASS_NAMES)):
+            hist = snapshot.rsp_hist(op, pclass)
+            if nokia_mdipc_stats.hist_count(hist) == 0:
+                continue
+            ops.append((nokia_mdipc_stats.STAT_OP_NAMES[op],
+                        nokia_mdipc_stats.PAGE_CLASS_NAMES[pclass],
+                        nokia_mdipc_stats.hist_to_dict(hist)))
+    waits = []
+    for op in range(len(nokia_mdipc_stats.STAT_OP_NAMES)):
+        hist = snapshot.wait_hist(op)
+        if nokia_mdipc_stats.hist_count(hist) == 0:
+            continue
+        waits.append((nokia_mdipc_stats.STAT_OP_NAMES[op], nokia_mdipc_stats.hist_to_dict(hist)))
+    class_waits = []
+    for req_class in range(len(nokia_mdipc_stats.REQ_CLASS_NAMES)):
+        hist = snapshot.class_wait_hist(req_class)
+        if nokia_mdipc_stats.hist_count(hist) == 0:
+            continue
+        class_waits.append((nokia_mdipc_stats.REQ_CLASS_NAMES[req_class], snapshot.class_no_channel(req_class),
+                            nokia_mdipc_stats.hist_to_dict(hist)))
+    channels = []
+    for chan in range(nokia_mdipc_stats.MDIPC_STATS_MAX_CHANNELS):
+        counters = {}
+        for i in range(len(nokia_mdipc_stats.CHAN_COUNTERS)):
+            counters[nokia_mdipc_stats.CHAN_COUNTERS[i]] = snapshot.chan_counter(chan, i)
+        if counters['msgs'] == 0:
+            continue
+        hist = [0] * nokia_mdipc_stats.HIST_SIZE
+        for op in range(len(nokia_mdipc_stats.STAT_OP_NAMES)):
+            for pclass in range(len(nokia_mdipc_stats.PAGE_CLASS_NAMES)):
+                chan_hist = snapshot.rsp_hist(op, pclass, chan)
+                for i in range(nokia_mdipc_stats.HIST_SIZE):
+                    if i == nokia_mdipc_stats.HIST_MAX:
+                        hist[i] = max(hist[i], chan_hist[i])
+                    else:
+                        hist[i] += chan_hist[i]
+        channels.append((chan, counters, nokia_mdipc_stats.hist_to_dict(hist)))
+
+    if format_type == 'json-format':
+        json_dict = {
+            'processes': snapshot.processes,
+            'no_channel_avail': snapshot.global_counter(nokia_mdipc_stats.GLOBAL_NO_CHANNEL_AVAIL),
+            'response': [{'op': op, 'page_class': pclass, 'latency': hist} for op, pclass, hist in ops],
+            'queue_wait': [{'op': op, 'latency': hist} for op, hist in waits],
+            'class_wait': [{'class': name, 'no_channel_avail': no_channel, 'latency': hist}
+                           for name, no_channel, hist in class_waits],
+            'channels': [{'channel': chan, 'counters': counters, 'latency': hist} for chan, counters, hist in channels]
+        }
+        print(json.dumps(json_dict, indent=4))
+        return
+
+    now_ns = time.time_ns()
+    field = ['Pid       ', 'Msgs        ', 'Last Update  ']
+    item_list = []
+    for proc in snapshot.processes:
+        item_list.append([str(proc['pid']), str(proc['msgs']),
+                          pretty_time_delta((now_ns - proc['update_ns']) / 1e9).strip() + ' ago'])
+    print('MDIPC CLIENT PROCESSES')
+    print_table(field, item_list)
+
+    field = ['Op        ', 'Page Class', 'Count       ', 'Avg(us)   ', 'P50(us)   ', 'P99(us)   ', 'Max(us)   ']
+    item_list = []
+    for op, pclass, hist in ops:
+        item_list.append([op, pclass, str(hist['count']), str(hist['avg_us']),
+                          str(hist['p50_us']), str(hist['p99_us']), str(hist['max_us'])])
+    print('MDIPC RESPONSE LATENCY')
+    print_table(field, item_list)
+
+    field = ['Op        ', 'Count       ', 'Avg(us)   ', 'P50(us)   ', 'P99(us)   ', 'Max(us)   ']
+    item_list = []
+    for op, hist in waits:
+        item_list.append([op, str(hist['count']), str(hist['avg_us']),
+                          str(hist['p50_us']), str(hist['p99_us']), str(hist['max_us'])])
+    print('MDIPC CHANNEL QUEUE WAIT (no channel available: {})'.format(
+        snapshot.global_counter(nokia_mdipc_stats.GLOBAL_NO_CHANNEL_AVAIL)))
+    print_table(field, item_list)
+
+    field = ['Class     ', 'Count       ', 'Avg(us)   ', 'P50(us)   ', 'P99(us)   ', 'Max(us)   ', 'NoChannel ']
+    item_list = []
+    for name, no_channel, hist in class_waits:
+        item_list.append([name, str(hist['count']), str(hist['avg_us']), str(hist['p50_us']),
+                          str(hist['p99_us']), str(hist['max_us']), str(no_channel)])
+    print('MDIPC REQUEST CLASS WAIT')
+    print_table(field, item_list)
+
+    field = ['Chan', 'Msgs        ', 'Success     ', 'Fail      ', 'NotPresent', 'Timeouts  ',
+             'LongRsp   ', 'InUse     ', 'P99(us)   ', 'Max(us)   ']
+    item_list = []
+    for chan, counters, hist in channels:
+        item_list.append([str(chan), str(counters['msgs']), str(counters['success']), str(counters['fail']),
+                          str(counters['notpresent']), str(counters['timeouts']), str(counters['long_rsp']),
+                          str(counters['already_in_use']), str(hist['p99_us']), str(hist['max_us'])])
+    print('MDIPC CHANNELS')
+    print_table(field, item_list)
+
+
+def show_inventory_cache():
+    stats = nokia_inventory.get_stats()
+    if format_type == 'json-format':
+        print(json.dumps(stats, indent=4))
+        return
+
+    header = stats['header']
+    if header is None:
+        print('Inventory cache: empty')
+    else:
+        print('Inventory cache: slot {} server {}'.format(header['my_slot'], header['server']))
+        field = ['Entry                       ']
+        print_table(field, [[entry] for entry in stats['entries']])
+
+    field = ['Process           ', 'Pid       ', 'Sample    ', 'First(ms)   ', 'Cache     ']
+    item_list = []
+    for name, proc in stats['processes'].items():
+        for kind, sample in sorted(proc['samples'].items()):
+            item_list.append([name, str(proc['pid']), kind, str(sample['msecs']), sample['cache']])
+    print('TIME TO FIRST SAMPLE')
+    print_table(field, item_list)
+
+
+def show_rpc_recorder():
+    dumps = nokia_common.rpc_recorder_collect()
+    if format_type == 'json-format':
+        print(json.dumps(dumps, indent=4))
+        return
+
+    field = ['Process             ', 'Time          ', 'Id           ', 'Method                                  ',
+             'Setup(ms) ', 'Rpc(ms)   ', 'Status      ', 'Request']
+    item_list = []
+    for name, entries in dumps.items():
+        for entry in entries:
+            setup_ms = '-' if entry['setup_ms'] is None else str(entry['setup_ms'])
+            # '/platform_ndk.FanPlatformNdkService/SetFanTargetSpeed' -> 'FanPlatformNdkService.SetFanTargetSpeed'
+            method = entry['method'].strip('/').rsplit('.', 1)[-1].replace('/', '.')
+            item_list.append([name, entry['time'], entry['id'], method,
+                              setup_ms, str(entry['rpc_ms']), entry['status'], entry['request']])
+    item_list.sort(key=lambda item: item[1])
+    print('RPC FLIGHT RECORDER (slow threshold {}ms)'.format(nokia_common.NOKIA_RPC_SLOW_MSECS))
+    print_table(field, item_list)
+
+
 def show_midplane_port_counters(port):
     global format_type
     if nokia_common.is_cpm() == 0:
@@ -2007,12 +2198,28 @@ def set_startup_sfm(num):
         outstr = stdout.decode('ascii')
     return
 
-def main():
+def run_command(argv):
     global format_type
+    format_type = ''
 
-    base_parser = argparse.ArgumentParser()
+    base_parser = argparse.ArgumentParser(prog='nokia_cmd')
+    # parsed by main(), listed here for the help text
+    base_parser.add_argument('--watch', type=float, metavar='INTERVAL', help='re-run the command every INTERVAL seconds, highlighting changes')
+    base_parser.add_argument('--timing', action='store_true', help='print the time taken by each command')
     subparsers = base_parser.add_subparsers(help='sub-commands', dest="cmd")
 
+    # Session: nokia_cmd [--timing] session [file], handled in main()
+    session_parser = subparsers.add_parser('session', help='run commands from stdin or a file in one process')
+    session_parser.add_argument('file', nargs='?', help='command file, one command per line')
+
+    # Collect: concurrent capture of show sections into files
+    collect_parser = subparsers.add_parser('collect', help='capture show sections concurrently into files')
+    collect_parser.add_argument('--dir', required=True, help='output directory')
+    collect_parser.add_argument('--sections', default=','.join(sorted(COLLECT_SECTIONS)),
+                                help='comma separated list of: ' + ', '.join(sorted(COLLECT_SECTIONS)))
+    collect_parser.add_argument('--timeout', type=float, default=COLLECT_DEFAULT_TIMEOUT,
+                                help='seconds, sections still running are killed')
+
     # Show Commands
     show_parser = subparsers.add_parser('show', help='show help')
     showsubparsers = show_parser.add_subparsers(help='show cmd options', dest="showcmd")
@@ -2112,6 +2319,18 @@ def main():
     show_asictemp_parser = showsubparsers.add_parser('asic-temperature', help='show asic-temperature info')
     show_asictemp_parser.add_argument('json-format', nargs='?', help='show asic-temperature <json-format>')
 
+    # show mdipc-stats
+    show_mdipcstats_parser = showsubparsers.add_parser('mdipc-stats', help='show MDIPC transceiver access statistics')
+    show_mdipcstats_parser.add_argument('json-format', nargs='?', help='show mdipc-stats <json-format>')
+
+    # show inventory-cache
+    show_invcache_parser = showsubparsers.add_parser('inventory-cache', help='show warm-start inventory cache and time to first sample')
+    show_invcache_parser.add_argument('json-format', nargs='?', help='show inventory-cache <json-format>')
+
+    # show rpc-recorder
+    show_rpcrec_parser = showsubparsers.add_parser('rpc-recorder', help='show the last platform NDK RPCs of pmon processes')
+    show_rpcrec_parser.add_argument('json-format', nargs='?', help='show rpc-recorder <json-format>')
+
     # show qfpga
     show_qfpga_parser = showsubparsers.add_parser('qfpga', help='show qfpga')
     show_qfpga_sub_parser = show_qfpga_parser.add_subparsers(help='show qfpga options', dest="qfpgacmd")
@@ -2227,7 +2446,7 @@ def main():
     clear_qfpga_stats_parser.add_argument('stats', nargs='?', help='clear stats')
 
     # An illustration of how access the arguments.
-    args = base_parser.parse_args()
+    args = base_parser.parse_args(argv)
     d = vars(args)
     if args.cmd == 'show':
         if args.showcmd == 'platform':
@@ -2303,6 +2522,15 @@ def main():
         elif args.showcmd == 'asic-temperature':
             format_type = d['json-format']
             show_asic_temperature()
+        elif args.showcmd == 'mdipc-stats':
+            format_type = d['json-format']
+            show_mdipc_stats()
+        elif args.showcmd == 'inventory-cache':
+            format_type = d['json-format']
+            show_inventory_cache()
+        elif args.showcmd == 'rpc-recorder':
+            format_type = d['json-format']
+            show_rpc_recorder()
         elif args.showcmd == 'qfpga':
             if 'json-format' in d:
                 format_type = d['json-format']
@@ -2414,8 +2642,254 @@ def main():
           clear_midplane_port_counters()
         if args.clearcmd == 'qfpga':
           clear_qfpga_stats()
+    elif args.cmd == 'session':
+        print('session is not supported inside a session')
+    elif args.cmd == 'collect':
+        if nokia_common.channel_cache_active():
+            print('collect is not supported inside a session')
+            return
+        sections = [name.strip() for name in d['sections'].split(',') if name.strip()]
+        unknown = [name for name in sections if name not in COLLECT_SECTIONS]
+        if unknown:
+            print('Unknown sections {}. Choose from {}'.format(unknown, sorted(COLLECT_SECTIONS)))
+            return
+        run_collect(d['dir'], sections, d['timeout'])
     else:
         base_parser.print_help()
 
+
+def timed_command(argv, timing):
+    start = time.monotonic()
+    try:
+        run_command(argv)
+    except SystemExit:
+        # argparse error or help, already printed
+        pass
+    elapsed = (time.monotonic() - start) * 1000
+    sys.stdout.flush()
+    if timing:
+        print('# {}: {:.1f} ms'.format(' '.join(argv), elapsed))
+    return elapsed
+
+
+def run_session(path, timing):
+    """
+    Run one nokia_cmd command per line from path or stdin, e.g.
+        show psus
+        show sensors json-format
+    Blank lines and lines starting with '#' are skipped, 'exit' ends the
+    session. gRPC channels are kept open across the commands.
+    """
+    interactive = path is None and sys.stdin.isatty()
+    stream = open(path, 'r') if path else sys.stdin
+    count = 0
+    total = 0.0
+    try:
+        while True:
+            if interactive:
+                try:
+                    line = input('nokia_cmd> ')
+                except EOFError:
+                    print('')
+                    break
+            else:
+                line = stream.readline()
+                if not line:
+                    break
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            if line in ('exit', 'quit'):
+                break
+            try:
+                argv = shlex.split(line)
+            except ValueError as e:
+                print('Invalid command "{}": {}'.format(line, e))
+                continue
+            total += timed_command(argv, timing)
+            count += 1
+    finally:
+        if path:
+            stream.close()
+    if timing:
+        print('# {} commands: {:.1f} ms'.format(count, total))
+
+
+def _highlight_deltas(prev, cur):
+    """
+    Mark the table cells (or whole lines outside tables) of cur that differ
+    from prev in reverse video
+    """
+    if prev is None:
+        return cur
+    prev_lines = prev.splitlines()
+    lines = []
+    for i, line in enumerate(cur.splitlines()):
+        old = prev_lines[i] if i < len(prev_lines) else ''
+        if line == old:
+            lines.append(line)
+            continue
+        cells = line.split('|')
+        old_cells = old.split('|')
+        if len(cells) > 1 and len(cells) == len(old_cells):
+            line = '|'.join(c if c == o else '\033[7m' + c + '\033[0m' for c, o in zip(cells, old_cells))
+        else:
+            line = '\033[7m' + line + '\033[0m'
+        lines.append(line)
+    return '\n'.join(lines)
+
+
+def run_watch(interval, argv, timing):
+    """
+    Re-run a command every interval seconds, like watch(1), highlighting
+    what changed since the previous run
+    """
+    tty = sys.stdout.isatty()
+    prev = None
+    try:
+        while True:
+            buf = io.StringIO()
+            start = time.monotonic()
+            with contextlib.redirect_stdout(buf):
+                try:
+                    run_command(argv)
+                except SystemExit:
+                    pass
+            elapsed = (time.monotonic() - start) * 1000
+            out = buf.getvalue()
+
+            if tty:
+                sys.stdout.write('\033[H\033[2J')
+            print('Every {}s: nokia_cmd {}    {}'.format(interval, ' '.join(argv), time.strftime('%c')))
+            if timing:
+                print('# {:.1f} ms'.format(elapsed))
+            print('')
+            print(_highlight_deltas(prev, out) if tty else out)
+            sys.stdout.flush()
+            prev = out
+            time.sleep(max(0, interval - elapsed / 1000))
+    except KeyboardInterrupt:
+        pass
+
+
+def _collect_job(path, commands):
+    """
+    Forked child: run commands with stdout and stderr appended to path
+    """
+    code = 0
+    try:
+        fd = os.open(path, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o644)
+        os.dup2(fd, 1)
+        os.dup2(fd, 2)
+        os.close(fd)
+        nokia_common.channel_cache_enable()
+        for argv in commands:
+            print('#' * 80)
+            print('# [Command]: nokia_cmd {}  ### {}'.format(' '.join(argv), time.strftime('%Y-%m-%d_%H:%M:%S')))
+            print('#' * 80)
+            try:
+                run_command(argv)
+            except SystemExit:
+                pass
+            except Exception as e:
+                print('Command failed: {}'.format(e))
+                code = 1
+            sys.stdout.flush()
+    finally:
+        sys.stdout.flush()
+        sys.stderr.flush()
+        os._exit(code)
+
+
+def run_collect(outdir, sections, timeout):
+    """
+    Capture the given COLLECT_SECTIONS into outdir, the table and the
+    json-format output of every section each in its own process so that
+    the whole capture takes about as long as the slowest section. The
+    children are forked before this process opens any gRPC channel.
+    """
+    if not os.path.isdir(outdir):
+        os.makedirs(outdir)
+
+    jobs = []
+    for name in sections:
+        base, commands = COLLECT_SECTIONS[name]
+        jobs.append((name, os.path.join(outdir, base + '.txt'), commands))
+        json_commands = [argv + ['json-format'] for argv in commands if argv not in COLLECT_NO_JSON]
+        if json_commands:
+            jobs.append((name + ' (json)', os.path.join(outdir, base + '.json'), json_commands))
+
+    sys.stdout.flush()
+    sys.stderr.flush()
+    start = time.monotonic()
+    running = {}
+    for job in jobs:
+        pid = os.fork()
+        if pid == 0:
+            _collect_job(job[1], job[2])
+        running[pid] = job
+
+    results = {}
+    deadline = start + timeout
+    while running:
+        pid, status = os.waitpid(-1, os.WNOHANG)
+        if pid == 0:
+            if time.monotonic() < deadline:
+                time.sleep(0.01)
+                continue
+            for pid in running:
+                os.kill(pid, signal.SIGKILL)
+            for pid, job in running.items():
+                os.waitpid(pid, 0)
+                with open(job[1], 'a') as f:
+                    f.write('Section timed out after {} seconds\n'.format(timeout))
+                results[job[0]] = (job[1], 'timeout', timeout * 1000)
+            break
+        job = running.pop(pid)
+        if os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0:
+            result = 'ok'
+        else:
+            result = 'failed'
+        results[job[0]] = (job[1], result, (time.monotonic() - start) * 1000)
+
+    field = ['Section                 ', 'File                                ', 'Result  ', 'Time(ms)  ']
+    item_list = []
+    for job in jobs:
+        path, result, elapsed = results[job[0]]
+        item_list.append([job[0], os.path.basename(path), result, '{:.0f}'.format(elapsed)])
+    print('NOKIA_CMD COLLECT')
+    print_table(field, item_list)
+    print('Total time: {:.0f} msec'.format((time.monotonic() - start) * 1000))
+
+
+def main():
+    parser = argparse.ArgumentParser(prog='nokia_cmd', add_help=False)
+    parser.add_argument('--watch', type=float, metavar='INTERVAL', help='re-run the command every INTERVAL seconds')
+    parser.add_argument('--timing', action='store_true', help='print the time taken by each command')
+    parser.add_argument('command', nargs=argparse.REMAINDER)
+    opts, unknown = parser.parse_known_args()
+    argv = unknown + opts.command
+
+    if opts.watch is not None or (argv and argv[0] == 'session'):
+        nokia_common.channel_cache_enable()
+
+    try:
+        if opts.watch is not None:
+            if opts.watch <= 0 or not argv:
+                print('Usage: nokia_cmd --watch INTERVAL <command>')
+                return
+            run_watch(opts.watch, argv, opts.timing)
+        elif argv and argv[0] == 'session':
+            if len(argv) > 2:
+                print('Usage: nokia_cmd session [file]')
+                return
+            run_session(argv[1] if len(argv) == 2 else None, opts.timing)
+        elif opts.timing:
+            timed_command(argv, True)
+        else:
+            run_command(argv)
+    finally:
+        nokia_common.channel_cache_disable()
+
 if __name__ == "__main__":
     main()
@@ -7,13 +7,24 @@
 # All rights reserved.
 #
 
+import atexit
+import collections
+import fcntl
+import glob
+import itertools
+import json
 import os
+import sys
+import threading
+import time
 from sonic_platform_base.device_base import DeviceBase
 from sonic_platform_base.module_base import ModuleBase
 import grpc
 from platform_ndk import platform_ndk_pb2
 from platform_ndk import platform_ndk_pb2_grpc
+from platform_ndk import nokia_replay
 from datetime import datetime
+from sonic_py_common.logger import Logger
 
 NOKIA_MIDPLANE_SUBNET = "10.6."
 NOKIA_UNIX_SOCKET_PREFIX = "unix://"
@@ -64,6 +75,19 @@ NOKIA_GRPC_EEPROM_SERVICE = 'Eeprom-Service'
 NOKIA_GRPC_MIDPLANE_SERVICE = 'Midplane-Service'
 NOKIA_GRPC_QFPGA_SERVICE = 'Qfpga-Service'
 
+NOKIA_RPC_RECORDER_SIZE = 256
+NOKIA_RPC_SLOW_MSECS = 500
+NOKIA_RPC_CORRELATION_KEY = 'x-nokia-correlation-id'
+# shared by the host and pmon, which do not share the pid namespace: a
+# registered process holds an flock on its '.lock' file for its lifetime
+# and polls the request file for dumps to write
+NOKIA_RPC_RECORDER_DIR = '/var/run/redis/'
+NOKIA_RPC_RECORDER_PREFIX = 'nokia_rpc_recorder.'
+NOKIA_RPC_RECORDER_POLL_SECS = 0.25
+# only these long-running pmon daemons register with rpc_recorder_collect()
+NOKIA_RPC_RECORDER_DAEMONS = ('chassisd', 'thermalctld', 'xcvrd', 'psud', 'ledd',
+                              'syseepromd', 'pcied', 'sensormond')
+
 HW_SLOT_TO_EXTERNAL_SLOT_MAPPING = {
     0: "A",
     1: "1",
@@ -89,53 +113,148 @@ HW_SLOT_TO_EXTERNAL_SLOT_MAPPING = {
 
 my_chassis_type = platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_INVALID
 
+logger = Logger("nokia_common")
 
-def channel_setup(service):
-    if service == NOKIA_GRPC_MIDPLANE_SERVICE:
-       server_path = NOKIA_MIDPLANE_ETHMGR_SOCKET_PATH
-    elif service == NOKIA_GRPC_QFPGA_SERVICE:
-       server_path = NOKIA_QFPGA_SOCKET_PATH
-    else:
-       server_path = NOKIA_DEVMGR_UNIX_SOCKET_PATH
+# RPC flight recorder: the last NOKIA_RPC_RECORDER_SIZE RPCs made through
+# try_grpc(), always on. Each RPC carries a correlation id as gRPC metadata
+# so a slow RPC logged here can be matched with the server's logs. The
+# channel setup time of the thread's last channel_setup() is charged to
+# the next RPC it makes.
+_rpc_ring = collections.deque(maxlen=NOKIA_RPC_RECORDER_SIZE)
+_rpc_seq = itertools.count(1)
+_rpc_setup = threading.local()
 
-    if os.path.exists(NOKIA_CHANNEL_FILE_PATH):
-        server_path = (open(NOKIA_CHANNEL_FILE_PATH, 'r').readline().rstrip())
-    _channel = grpc.insecure_channel(server_path)
-    _stub = None
+# Long running users (nokia_cmd session/watch) keep channels open across
+# commands: one channel per server and one stub per service on it.
+# channel_shutdown() leaves cached channels open.
+_channel_cache = None
+_channel_cache_lock = threading.Lock()
 
-    _channel_ready = grpc.channel_ready_future(_channel)
-    try:
-        _channel_ready.result(timeout=0.5)
-    except grpc.FutureTimeoutError:
-        _channel = None
+
+def channel_cache_enable():
+    global _channel_cache
+    with _channel_cache_lock:
+        if _channel_cache is None:
+            _channel_cache = {}
+
+
+def channel_cache_disable():
+    global _channel_cache
+    with _channel_cache_lock:
+        cache = _channel_cache
+        _channel_cache = None
+    if cache:
+        for _channel, stubs in cache.values():
+            _channel.close()
+
+
+def channel_cache_active():
+    return _channel_cache is not None
+
+
+def _channel_cache_get(server_path, service):
+    if _channel_cache is None:
+        return None, None
+    with _channel_cache_lock:
+        entry = _channel_cache.get(server_path)
+        if entry is None:
+            return None, None
+        return entry[0], entry[1].get(service)
+
+
+def _channel_cache_put(server_path, service, _channel, _stub):
+    if _channel_cache is None or _stub is None:
         return _channel, _stub
+    with _channel_cache_lock:
+        entry = _channel_cache.get(server_path)
+        if entry is None:
+            _channel_cache[server_path] = (_channel, {service: _stub})
+            return _channel, _stub
+        if entry[0] is _channel:
+            _stub = entry[1].setdefault(service, _stub)
+            return _channel, _stub
+        _stub = entry[1].setdefault(service, _service_stub(service, entry[0]))
+    # another thread connected first, use its channel
+    _channel.close()
+    return entry[0], _stub
+
 
+def _service_stub(service, _channel):
     if service == NOKIA_GRPC_CHASSIS_SERVICE:
-        _stub = platform_ndk_pb2_grpc.ChassisPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.ChassisPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_PSU_SERVICE:
-        _stub = platform_ndk_pb2_grpc.PsuPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.PsuPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_FAN_SERVICE:
-        _stub = platform_ndk_pb2_grpc.FanPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.FanPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_THERMAL_SERVICE:
-        _stub = platform_ndk_pb2_grpc.ThermalPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.ThermalPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_LED_SERVICE:
-        _stub = platform_ndk_pb2_grpc.LedPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.LedPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_XCVR_SERVICE:
-        _stub = platform_ndk_pb2_grpc.XcvrPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.XcvrPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_FIRMWARE_SERVICE:
-        _stub = platform_ndk_pb2_grpc.FirmwarePlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.FirmwarePlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_UTIL_SERVICE:
-        _stub = platform_ndk_pb2_grpc.UtilPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.UtilPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_EEPROM_SERVICE:
-        _stub = platform_ndk_pb2_grpc.EepromPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.EepromPlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_MIDPLANE_SERVICE:
-        _stub = platform_ndk_pb2_grpc.MidplanePlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.MidplanePlatformNdkServiceStub(_channel)
     elif service == NOKIA_GRPC_QFPGA_SERVICE:
-        _stub = platform_ndk_pb2_grpc.QfpgaPlatformNdkServiceStub(_channel)
+        return platform_ndk_pb2_grpc.QfpgaPlatformNdkServiceStub(_channel)
+    return None
 
+
+def channel_setup(service):
+    start = time.monotonic()
+    _channel, _stub = _channel_setup(service)
+    _rpc_setup.secs = time.monotonic() - start
     return _channel, _stub
 
+
+def _replay_channel_setup(service):
+    _channel = nokia_replay.replay_channel()
+    return _channel, _service_stub(service, _channel)
+
+
+def _channel_setup(service):
+    if nokia_replay.replaying():
+        return _replay_channel_setup(service)
+
+    if service == NOKIA_GRPC_MIDPLANE_SERVICE:
+       server_path = NOKIA_MIDPLANE_ETHMGR_SOCKET_PATH
+    elif service == NOKIA_GRPC_QFPGA_SERVICE:
+       server_path = NOKIA_QFPGA_SOCKET_PATH
+    else:
+       server_path = NOKIA_DEVMGR_UNIX_SOCKET_PATH
+
+    if os.path.exists(NOKIA_CHANNEL_FILE_PATH):
+        server_path = (open(NOKIA_CHANNEL_FILE_PATH, 'r').readline().rstrip())
+
+    _channel, _stub = _channel_cache_get(server_path, service)
+    if _stub is not None:
+        return _channel, _stub
+    if _channel is None:
+        _channel = grpc.insecure_channel(server_path)
+        _channel_ready = grpc.channel_ready_future(_channel)
+        try:
+            _channel_ready.result(timeout=0.5)
+        except grpc.FutureTimeoutError:
+            _channel = None
+            return _channel, _stub
+        _channel = nokia_replay.record_channel(_channel)
+
+    _stub = _service_stub(service, _channel)
+    return _channel_cache_put(server_path, service, _channel, _stub)
+
 def midplane_channel_setup(service, hw_slot):
+    start = time.monotonic()
+    _channel, _stub = _midplane_channel_setup(service, hw_slot)
+    _rpc_setup.secs = time.monotonic() - start
+    return _channel, _stub
+
+
+def _midplane_channel_setup(service, hw_slot):
     midplane_ip = NOKIA_MIDPLANE_SUBNET + str(hw_slot) + '.100' + ':'
     if service == NOKIA_GRPC_MIDPLANE_SERVICE:
       #Midplane/Ethmgr is supported only in CPM
@@ -145,44 +264,81 @@ def midplane_channel_setup(service, hw_slot):
     else:
         server_path = midplane_ip + NOKIA_DEVMGR_SONIC_SRVR_PORT
 
+    if nokia_replay.replaying():
+        return _replay_channel_setup(service)
+
     if os.path.exists(NOKIA_CHANNEL_FILE_PATH):
         server_path = (open(NOKIA_CHANNEL_FILE_PATH, 'r').readline().rstrip())
-    _channel = grpc.insecure_channel(server_path)
-    _stub = None
 
-    _channel_ready = grpc.channel_ready_future(_channel)
-    try:
-        _channel_ready.result(timeout=0.5)
-    except grpc.FutureTimeoutError:
-        _channel = None
+    _channel, _stub = _channel_cache_get(server_path, service)
+    if _stub is not None:
         return _channel, _stub
+    if _channel is None:
+        _channel = grpc.insecure_channel(server_path)
+        _channel_ready = grpc.channel_ready_future(_channel)
+        try:
+            _channel_ready.result(timeout=0.5)
+        except grpc.FutureTimeoutError:
+            _channel = None
+            return _channel, _stub
+        _channel = nokia_replay.record_channel(_channel)
 
-    if service == NOKIA_GRPC_CHASSIS_SERVICE:
-        _stub = platform_ndk_pb2_grpc.ChassisPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_PSU_SERVICE:
-        _stub = platform_ndk_pb2_grpc.PsuPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_FAN_SERVICE:
-        _stub = platform_ndk_pb2_grpc.FanPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_THERMAL_SERVICE:
-        _stub = platform_ndk_pb2_grpc.ThermalPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_LED_SERVICE:
-        _stub = platform_ndk_pb2_grpc.LedPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_XCVR_SERVICE:
-        _stub = platform_ndk_pb2_grpc.XcvrPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_FIRMWARE_SERVICE:
-        _stub = platform_ndk_pb2_grpc.FirmwarePlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_UTIL_SERVICE:
-        _stub = platform_ndk_pb2_grpc.UtilPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_EEPROM_SERVICE:
-        _stub = platform_ndk_pb2_grpc.EepromPlatformNdkServiceStub(_channel)
-    elif service == NOKIA_GRPC_QFPGA_SERVICE:
-        _stub = platform_ndk_pb2_grpc.QfpgaPlatformNdkServiceStub(_channel)
-    return _channel, _stub
+    _stub = _service_stub(service, _channel)
+    return _channel_cache_put(server_path, service, _channel, _stub)
 
 def channel_shutdown(_channel):
+    with _channel_cache_lock:
+        if _channel_cache is not None:
+            for cached_channel, stubs in _channel_cache.values():
+                if cached_channel is _channel:
+                    return
     _channel.close()
 
 
+def _rpc_method_name(callback):
+    # grpc stub methods know their '/package.Service/Method' path
+    method = getattr(callback, '_method', None)
+    if method is None:
+        return getattr(callback, '__qualname__', str(callback))
+    if isinstance(method, bytes):
+        return method.decode()
+    return method
+
+
+def _rpc_error_response(e):
+    status_code = platform_ndk_pb2.ResponseCode.NDK_ERR_FAILURE
+    err_msg = 'Grpc error code '+str(e.code())
+    resp_status = platform_ndk_pb2.ResponseStatus(status_code=status_code,
+                                                  error_msg=err_msg)
+    status = e.code().name if e.code() is not None else 'UNKNOWN'
+    return platform_ndk_pb2.DefaultResponse(response_status=resp_status), status
+
+
+def _rpc_no_response():
+    resp_status = platform_ndk_pb2.ResponseStatus(error_msg='No response available')
+    return platform_ndk_pb2.DefaultResponse(response_status=resp_status)
+
+
+def _rpc_record(correlation_id, method, request, setup_secs, rpc_secs, status):
+    record = (time.time(), correlation_id, method, request, setup_secs, rpc_secs, status)
+    _rpc_ring.append(record)
+    if (rpc_secs + (setup_secs or 0)) * 1000 >= NOKIA_RPC_SLOW_MSECS:
+        entry = _rpc_record_entry(record)
+        logger.log_warning("Slow RPC {} {} setup {}ms rpc {}ms status {} request {}".format(
+            entry['id'], entry['method'], entry['setup_ms'] or 0, entry['rpc_ms'], entry['status'],
+            entry['request']))
+
+
+def _rpc_correlation_id():
+    return '{:x}-{:x}'.format(os.getpid(), next(_rpc_seq))
+
+
+def _rpc_take_setup_secs():
+    setup_secs = getattr(_rpc_setup, 'secs', None)
+    _rpc_setup.secs = None
+    return setup_secs
+
+
 def try_grpc(callback, *args, **kwargs):
     """
     Handy function to invoke the callback and catch NotImplementedError
@@ -192,23 +348,302 @@ def try_grpc(callback, *args, **kwargs):
     :return: Default return value if exception occur else return value of the callback
     """
     return_val = True
+    status = 'OK'
+    correlation_id = _rpc_correlation_id()
+    setup_secs = _rpc_take_setup_secs()
+    start = time.monotonic()
     try:
-        resp = callback(*args)
+        if hasattr(callback, '_method'):
+            resp = callback(*args, metadata=((NOKIA_RPC_CORRELATION_KEY, correlation_id),))
+        else:
+            resp = callback(*args)
         if resp is None:
-            resp_status = platform_ndk_pb2.ResponseStatus(error_msg='No response available')
-            resp = platform_ndk_pb2.DefaultResponse(response_status=resp_status)
+            resp = _rpc_no_response()
             return_val = False
+            status = 'NO_RESPONSE'
     except grpc.RpcError as e:
-        status_code = platform_ndk_pb2.ResponseCode.NDK_ERR_FAILURE
-        err_msg = 'Grpc error code '+str(e.code())
-        resp_status = platform_ndk_pb2.ResponseStatus(status_code=status_code,
-                                                      error_msg=err_msg)
-        resp = platform_ndk_pb2.DefaultResponse(response_status=resp_status)
+        resp, status = _rpc_error_response(e)
         return_val = False
 
+    _rpc_record(correlation_id, _rpc_method_name(callback), args[0] if args else None,
+                setup_secs, time.monotonic() - start, status)
     return return_val, resp
 
 
+def try_grpc_batch(callback, requests, timeout=None):
+    """
+    Invokes the callback for every request without waiting for the
+    previous answer: the RPCs are in flight together on the callback's
+    channel and take about as long as the slowest one
+    :param callback: grpc stub method
+    :param requests: list of requests
+    :param timeout: per RPC timeout in seconds
+    :return: list of (ret, response) as try_grpc, in request order
+    """
+    if not hasattr(callback, 'future'):
+        return [try_grpc(callback, request) for request in requests]
+
+    setup_secs = _rpc_take_setup_secs()
+    method = _rpc_method_name(callback)
+    start = time.monotonic()
+    calls = []
+    for request in requests:
+        correlation_id = _rpc_correlation_id()
+        try:
+            future = callback.future(request, timeout=timeout,
+                                     metadata=((NOKIA_RPC_CORRELATION_KEY, correlation_id),))
+        except grpc.RpcError as e:
+            future = e
+        calls.append((correlation_id, request, future))
+
+    results = []
+    for correlation_id, request, future in calls:
+        return_val = True
+        status = 'OK'
+        try:
+            if isinstance(future, grpc.RpcError):
+                raise future
+            resp = future.result()
+            if resp is None:
+                resp = _rpc_no_response()
+                return_val = False
+                status = 'NO_RESPONSE'
+        except grpc.RpcError as e:
+            resp, status = _rpc_error_response(e)
+            return_val = False
+        # time until collected, the channel setup is charged to the batch once
+        _rpc_record(correlation_id, method, request, setup_secs, time.monotonic() - start, status)
+        setup_secs = None
+        results.append((return_val, resp))
+    return results
+
+
+def _rpc_record_entry(record):
+    when, correlation_id, method, request, setup_secs, rpc_secs, status = record
+    # summarized when read, not on every RPC
+    summary = ' '.join(str(request).split()) if request is not None else ''
+    if len(summary) > 80:
+        summary = summary[:77] + '...'
+    return {'time': datetime.fromtimestamp(when).strftime('%H:%M:%S.%f')[:-3],
+            'id': correlation_id, 'method': method, 'request': summary,
+            'setup_ms': None if setup_secs is None else round(setup_secs * 1000, 1),
+            'rpc_ms': round(rpc_secs * 1000, 1), 'status': status}
+
+
+def rpc_recorder_entries():
+    """
+    Returns this process' recorded RPCs, oldest first
+    """
+    # list() copies the deque without releasing the GIL, safe against
+    # appends from other threads and from the signal handler's thread
+    return [_rpc_record_entry(record) for record in list(_rpc_ring)]
+
+
+def _rpc_recorder_name():
+    return os.path.basename(sys.argv[0]) if sys.argv and sys.argv[0] else 'python'
+
+
+def _proc_identity(pid):
+    """
+    Returns (start time in clock ticks since boot, cmdline) of pid, None
+    if it does not exist
+    """
+    try:
+        with open('/proc/{}/stat'.format(pid), 'r') as f:
+            # comm may contain spaces, starttime is field 22
+            starttime = int(f.read().rsplit(')', 1)[1].split()[19])
+        with open('/proc/{}/cmdline'.format(pid), 'rb') as f:
+            cmdline = f.read().decode('utf-8', 'replace').rstrip('\0').split('\0')
+    except (OSError, ValueError, IndexError):
+        return None
+    return starttime, cmdline
+
+
+# this process' registration, see rpc_recorder_register()
+_rpc_recorder = {'pid': None, 'fd': None, 'base': None, 'request': None}
+
+
+def _rpc_recorder_request_file():
+    return NOKIA_RPC_RECORDER_DIR + NOKIA_RPC_RECORDER_PREFIX + 'request'
+
+
+def _read_rpc_recorder_request():
+    try:
+        with open(_rpc_recorder_request_file(), 'r') as f:
+            return f.read().strip()
+    except OSError:
+        return None
+
+
+def rpc_recorder_dump(request=None):
+    """
+    Writes the recorded RPCs of a registered process next to its lock
+    file, tagged with the request it answers
+    """
+    base = _rpc_recorder['base']
+    if base is None or _rpc_recorder['pid'] != os.getpid():
+        return
+    path = base + '.json'
+    try:
+        with open(path + '.tmp', 'w') as f:
+            json.dump({'pid': os.getpid(), 'request': request, 'entries': rpc_recorder_entries()}, f)
+        os.replace(path + '.tmp', path)
+    except OSError as e:
+        logger.log_warning("Unable to write {}: {}".format(path, e))
+
+
+def _rpc_recorder_poll():
+    while _rpc_recorder['pid'] == os.getpid():
+        time.sleep(NOKIA_RPC_RECORDER_POLL_SECS)
+        request = _read_rpc_recorder_request()
+        if request is not None and request != _rpc_recorder['request']:
+            _rpc_recorder['request'] = request
+            rpc_recorder_dump(request)
+
+
+def _open_rpc_recorder_lock():
+    """
+    Returns (base path, fd) of a lock file locked by this process. A
+    process of the other pid namespace may own the file of our pid.
+    """
+    base = NOKIA_RPC_RECORDER_DIR + NOKIA_RPC_RECORDER_PREFIX + '{}-{}'.format(_rpc_recorder_name(), os.getpid())
+    for n in range(8):
+        path = base if n == 0 else '{}-{}'.format(base, n)
+        fd = os.open(path + '.lock', os.O_RDWR | os.O_CREAT | os.O_NOFOLLOW | os.O_CLOEXEC, 0o644)
+        try:
+            fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+            # pruned between open and lock
+            if os.fstat(fd).st_ino == os.stat(path + '.lock').st_ino:
+                return path, fd
+        except OSError:
+            pass
+        os.close(fd)
+    raise OSError('no free recorder file for pid {}'.format(os.getpid()))
+
+
+def _rpc_recorder_reset():
+    _rpc_recorder.update({'pid': None, 'fd': None, 'base': None, 'request': None})
+
+
+def _rpc_recorder_remove():
+    if _rpc_recorder['base'] is None or _rpc_recorder['pid'] != os.getpid():
+        return
+    for suffix in ('.json', '.lock'):
+        try:
+            os.unlink(_rpc_recorder['base'] + suffix)
+        except OSError:
+            pass
+    os.close(_rpc_recorder['fd'])
+    _rpc_recorder_reset()
+
+
+def _rpc_recorder_after_fork():
+    # the child shares the parent's lock, it would keep a dead parent's
+    # dump looking alive
+    if _rpc_recorder['fd'] is not None:
+        os.close(_rpc_recorder['fd'])
+    _rpc_recorder_reset()
+
+
+os.register_at_fork(after_in_child=_rpc_recorder_after_fork)
+
+
+def rpc_recorder_register():
+    """
+    Registers this process with rpc_recorder_collect(), only the
+    NOKIA_RPC_RECORDER_DAEMONS do. A thread answers dump requests; the
+    files are removed at exit.
+    """
+    if _rpc_recorder_name() not in NOKIA_RPC_RECORDER_DAEMONS:
+        return False
+    if _rpc_recorder['pid'] == os.getpid():
+        return True
+    try:
+        base, fd = _open_rpc_recorder_lock()
+    except OSError as e:
+        logger.log_warning("Unable to register the RPC recorder: {}".format(e))
+        return False
+    _rpc_recorder.update({'pid': os.getpid(), 'fd': fd, 'base': base,
+                          'request': _read_rpc_recorder_request()})
+    rpc_recorder_dump(_rpc_recorder['request'])
+    atexit.register(_rpc_recorder_remove)
+    threading.Thread(target=_rpc_recorder_poll, name='rpc_recorder', daemon=True).start()
+    return True
+
+
+def _rpc_recorder_prune(lock_path):
+    """
+    Returns True if the owner of lock_path is alive, else removes its files
+    """
+    try:
+        fd = os.open(lock_path, os.O_RDONLY | os.O_NOFOLLOW | os.O_CLOEXEC)
+    except OSError:
+        return False
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+    except OSError:
+        os.close(fd)
+        return True
+    try:
+        # removed while locked, a new owner of the name gets a new inode
+        for path in (lock_path[:-len('.lock')] + '.json', lock_path):
+            try:
+                os.unlink(path)
+            except OSError:
+                pass
+    finally:
+        os.close(fd)
+    return False
+
+
+def _read_rpc_recorder_dump(path):
+    try:
+        with open(path, 'r') as f:
+            dump = json.load(f)
+    except (OSError, ValueError):
+        return None
+    return dump if isinstance(dump, dict) else None
+
+
+def rpc_recorder_collect(timeout=1.0):
+    """
+    Asks every registered process, host or pmon, to dump its recorder and
+    returns {'<process>-<pid>': [entries]}. A process that does not answer
+    within timeout is shown with its last dump; files of exited processes
+    are removed.
+    """
+    prefix = NOKIA_RPC_RECORDER_DIR + NOKIA_RPC_RECORDER_PREFIX
+    bases = [lock_path[:-len('.lock')] for lock_path in sorted(glob.glob(prefix + '*.lock'))
+             if _rpc_recorder_prune(lock_path)]
+    if not bases:
+        return {}
+
+    request = '{}-{}'.format(os.getpid(), time.time_ns())
+    request_file = _rpc_recorder_request_file()
+    try:
+        with open(request_file + '.tmp', 'w') as f:
+            f.write(request)
+        os.replace(request_file + '.tmp', request_file)
+    except OSError as e:
+        logger.log_warning("Unable to write {}: {}".format(request_file, e))
+        timeout = 0
+
+    deadline = time.monotonic() + timeout
+    dumps = {}
+    while True:
+        for base in bases:
+            dump = _read_rpc_recorder_dump(base + '.json')
+            if dump is not None and 'entries' in dump:
+                dumps[base] = dump
+        answered = all(dumps.get(base, {}).get('request') == request for base in bases)
+        if answered or time.monotonic() >= deadline:
+            break
+        time.sleep(0.05)
+
+    return dict((os.path.basename(base)[len(NOKIA_RPC_RECORDER_PREFIX):], dump['entries'])
+                for base, dump in dumps.items())
+
+
 def is_cpm():
     channel, stub = channel_setup(NOKIA_GRPC_CHASSIS_SERVICE)
     if not channel or not stub:
@@ -260,7 +695,10 @@ def get_chassis_type():
 
 
 def is_chassis_modular():
-    chassis_type = get_chassis_type()
+    return is_chassis_type_modular(get_chassis_type())
+
+
+def is_chassis_type_modular(chassis_type):
     if ((chassis_type == platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_IXR6) or
         (chassis_type == platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_IXR10) or
         (chassis_type == platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_IXR6E) or
@@ -382,17 +820,19 @@ def _power_onoff_SFM(hw_slot, powerOn):
     channel_shutdown(channel)
     return True
 
-def _get_sfm_eeprom_info_list():
+def _get_sfm_eeprom_info_list(timeout=None):
     """
-    Get all sfm eeprom info into a list.
+    Get all sfm eeprom info into a list, None on failure.
     """
     channel, stub = channel_setup(NOKIA_GRPC_UTIL_SERVICE)
     if not channel or not stub:
-        return
+        return None
 
     req_etype = platform_ndk_pb2.ReqSfmOpsType.SFM_OPS_SHOW_EEPROM
-    response = stub.ReqSfmInfo(platform_ndk_pb2.ReqSfmInfoPb(type=req_etype))
+    ret, response = try_grpc(stub.ReqSfmInfo, platform_ndk_pb2.ReqSfmInfoPb(type=req_etype), timeout)
     channel_shutdown(channel)
+    if ret is False:
+        return None
     return response.sfm_eeprom.eeprom_info
     
 def _tx_disable_all_sfps():
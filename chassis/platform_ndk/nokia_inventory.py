@@ -0,0 +1,267 @@
+# Name: nokia_inventory.py, version: 1.0
+#
+# Description: Warm-start cache of the static chassis inventory (chassis
+# properties, PSU/fan/thermal/component/SFP counts ...) returned by the
+# platform NDK. The responses do not change while the NDK is up, so they
+# are kept in NOKIA_INVENTORY_CACHE_FILE and reused by every pmon daemon
+# and across daemon restarts. The file is keyed by the kernel boot id, the
+# identity of the NDK server socket and the card slot, and is validated
+# with a GetMySlot when a process first uses it, every
+# NOKIA_INVENTORY_VALIDATE_SECS and after a failed RPC, so a daemon that
+# outlives an NDK restart drops the old answers. An NDK reached over TCP
+# has no identity that changes when it restarts, nothing is cached then.
+# Answers about hot-swappable FRUs (e.g. SFM EEPROMs) must not go through
+# here.
+#
+# Also records the time from process start to the first sample of each
+# kind (thermal, psu, fan, module) so warm and cold starts can be compared.
+# The files are in /var/run/redis, shared by pmon and the host where
+# 'nokia_cmd show inventory-cache' runs.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import base64
+import glob
+import json
+import os
+import sys
+import threading
+import time
+from sonic_py_common.logger import Logger
+from platform_ndk import nokia_common
+from platform_ndk import platform_ndk_pb2
+
+logger = Logger("nokia_inventory")
+
+NOKIA_INVENTORY_CACHE_FILE = '/var/run/redis/nokia_inventory_cache.json'
+NOKIA_INVENTORY_STATS_DIR = '/var/run/redis/'
+NOKIA_INVENTORY_STATS_PREFIX = 'nokia_inventory_stats.'
+NOKIA_INVENTORY_CACHE_VERSION = 2
+NOKIA_INVENTORY_VALIDATE_SECS = 60
+
+_lock = threading.RLock()
+# None until validated, then the header/entries of the cache in use
+_header = None
+_validated_at = None
+_entries = {}
+# False if the NDK instance cannot be identified
+_cacheable = False
+_hits = 0
+_misses = 0
+_first_samples = {}
+
+
+def _boot_id():
+    try:
+        with open('/proc/sys/kernel/random/boot_id') as f:
+            return f.read().strip()
+    except OSError:
+        return ''
+
+
+def _server_identity():
+    """
+    The NDK server socket is re-created on every NDK start, its inode
+    and mtime identify the running instance. None for a TCP server,
+    whose address stays the same across NDK restarts.
+    """
+    server_path = nokia_common.NOKIA_DEVMGR_UNIX_SOCKET_PATH
+    if os.path.exists(nokia_common.NOKIA_CHANNEL_FILE_PATH):
+        with open(nokia_common.NOKIA_CHANNEL_FILE_PATH, 'r') as f:
+            server_path = f.readline().rstrip()
+    if server_path.startswith(nokia_common.NOKIA_UNIX_SOCKET_PREFIX):
+        try:
+            st = os.stat(server_path[len(nokia_common.NOKIA_UNIX_SOCKET_PREFIX):])
+            return '{}:{}:{}'.format(server_path, st.st_ino, st.st_mtime_ns)
+        except OSError:
+            pass
+    return None
+
+
+def _read_cache_file():
+    try:
+        with open(NOKIA_INVENTORY_CACHE_FILE, 'r') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def _write_cache_file():
+    # merge with entries other daemons stored for the same NDK instance
+    cache = _read_cache_file()
+    entries = {}
+    if cache is not None and cache.get('header') == _header:
+        entries.update(cache.get('entries', {}))
+    entries.update(_entries)
+
+    tmp_file = '{}.{}'.format(NOKIA_INVENTORY_CACHE_FILE, os.getpid())
+    try:
+        with open(tmp_file, 'w') as f:
+            json.dump({'header': _header, 'entries': entries}, f)
+        os.replace(tmp_file, NOKIA_INVENTORY_CACHE_FILE)
+    except OSError as e:
+        logger.log_warning("Unable to write {}: {}".format(NOKIA_INVENTORY_CACHE_FILE, e))
+
+
+def _invalidate():
+    # the NDK may have restarted, validated again before the next use
+    global _header
+    _header = None
+
+
+def _validate():
+    """
+    Returns True while the cache is usable for this NDK instance
+    """
+    global _header, _entries, _cacheable, _validated_at
+    if _header is not None and time.monotonic() - _validated_at < NOKIA_INVENTORY_VALIDATE_SECS:
+        return True
+
+    channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE)
+    if not channel or not stub:
+        _invalidate()
+        return False
+    ret, response = nokia_common.try_grpc(stub.GetMySlot, platform_ndk_pb2.ReqModuleInfoPb())
+    nokia_common.channel_shutdown(channel)
+    if ret is False:
+        _invalidate()
+        return False
+
+    header = {'version': NOKIA_INVENTORY_CACHE_VERSION, 'boot_id': _boot_id(),
+              'server': _server_identity(), 'my_slot': response.my_slot}
+    _validated_at = time.monotonic()
+    if header == _header:
+        return True
+    _cacheable = header['server'] is not None
+    cache = _read_cache_file()
+    if not _cacheable:
+        _entries = {}
+        logger.log_info("Inventory cache disabled, NDK instance not identifiable")
+    elif cache is not None and cache.get('header') == header:
+        _entries = cache.get('entries', {})
+        logger.log_info("Inventory cache warm, {} entries".format(len(_entries)))
+    else:
+        _entries = {}
+        logger.log_info("Inventory cache cold")
+    _header = header
+    return True
+
+
+def _entry_key(method, request):
+    return '{}:{}'.format(method, request.SerializeToString().hex())
+
+
+def inventory_grpc(service, method, request, refresh=False):
+    """
+    Static inventory RPC, served from the warm-start cache when valid
+    :param service: nokia_common NOKIA_GRPC_*_SERVICE
+    :param method: RPC name, e.g. 'GetPsuNum'
+    :param request: request message
+    :param refresh: bypass the cache and store the live answer
+    :return: (ret, response) as try_grpc, (False, None) when the NDK is
+             unreachable
+    """
+    global _hits, _misses
+    key = _entry_key(method, request)
+    with _lock:
+        cacheable = _validate() and _cacheable
+        if cacheable and not refresh and key in _entries:
+            entry = _entries[key]
+            response_class = getattr(platform_ndk_pb2, entry['type'])
+            _hits += 1
+            return True, response_class.FromString(base64.b64decode(entry['data']))
+
+    channel, stub = nokia_common.channel_setup(service)
+    if not channel or not stub:
+        with _lock:
+            _invalidate()
+        return False, None
+    ret, response = nokia_common.try_grpc(getattr(stub, method), request)
+    nokia_common.channel_shutdown(channel)
+
+    with _lock:
+        _misses += 1
+        if not ret:
+            _invalidate()
+        elif cacheable and _header is not None:
+            _entries[key] = {'type': type(response).__name__,
+                             'data': base64.b64encode(response.SerializeToString()).decode()}
+            _write_cache_file()
+    return ret, response
+
+
+def my_slot():
+    """
+    Returns the card's hw slot as validated against the NDK, or
+    NOKIA_INVALID_SLOT_NUMBER
+    """
+    with _lock:
+        if not _validate():
+            return nokia_common.NOKIA_INVALID_SLOT_NUMBER
+        return _header['my_slot']
+
+
+def chassis_type():
+    ret, response = inventory_grpc(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE, 'GetChassisType',
+                                   platform_ndk_pb2.ReqModuleInfoPb())
+    if ret is False:
+        return nokia_common.get_chassis_type()
+    return response.chassis_type
+
+
+def _process_age_secs():
+    identity = nokia_common._proc_identity(os.getpid())
+    if identity is None:
+        raise OSError('no /proc entry for pid {}'.format(os.getpid()))
+    start_secs = identity[0] / os.sysconf('SC_CLK_TCK')
+    return time.clock_gettime(time.CLOCK_BOOTTIME) - start_secs
+
+
+def first_sample(kind):
+    """
+    Records the time to the first sample of kind in this process
+    """
+    if kind in _first_samples:
+        return
+    with _lock:
+        if kind in _first_samples:
+            return
+        try:
+            msecs = int(_process_age_secs() * 1000)
+        except (OSError, ValueError, IndexError):
+            return
+        warm = _header is not None and _hits > 0
+        _first_samples[kind] = {'msecs': msecs, 'cache': 'warm' if warm else 'cold',
+                                'hits': _hits, 'misses': _misses}
+        name = os.path.basename(sys.argv[0]) if sys.argv and sys.argv[0] else str(os.getpid())
+        logger.log_notice("{}: first {} sample {}ms after start, inventory cache {}".format(
+            name, kind, msecs, _first_samples[kind]['cache']))
+        # one file per process name, a restarted daemon replaces its own
+        path = NOKIA_INVENTORY_STATS_DIR + NOKIA_INVENTORY_STATS_PREFIX + name + '.json'
+        try:
+            with open(path + '.tmp', 'w') as f:
+                json.dump({'pid': os.getpid(), 'samples': _first_samples}, f)
+            os.replace(path + '.tmp', path)
+        except OSError:
+            pass
+
+
+def get_stats():
+    """
+    Returns the cache header, entry names and first-sample times of every
+    process that recorded them
+    """
+    cache = _read_cache_file() or {}
+    stats = {'header': cache.get('header'),
+             'entries': sorted(key.split(':', 1)[0] for key in cache.get('entries', {})),
+             'processes': {}}
+    prefix = NOKIA_INVENTORY_STATS_DIR + NOKIA_INVENTORY_STATS_PREFIX
+    for path in sorted(glob.glob(prefix + '*.json')):
+        try:
+            with open(path, 'r') as f:
+                stats['processes'][path[len(prefix):-len('.json')]] = json.load(f)
+        except (OSError, ValueError):
+            continue
+    return stats
@@ -6,6 +6,8 @@
 # Copyright (c) 2019, Nokia
 # All rights reserved.
 
+import threading
+import time
 from platform_ndk import nokia_common
 from platform_ndk import platform_ndk_pb2
 from sonic_py_common.logger import Logger
@@ -21,6 +23,12 @@ except ImportError as e:
 SYSLOG_IDENTIFIER = "led-mgmt"
 logger = Logger(SYSLOG_IDENTIFIER)
 
+# Port link events are held this long and sent as per-color port ranges
+LED_COALESCE_SECS = 0.05
+# ports whose SetLed failed are retried after this
+LED_RETRY_SECS = 1.0
+LED_STATS_LOG_SECS = 300
+
 
 class LedControlCommon(led_control_base.LedControlBase):
     def __init__(self):
@@ -41,6 +49,8 @@ class LedControlCommon(led_control_base.LedControlBase):
                 swsscommon.SonicDBConfig.load_sonic_db_config()
             self.platform_sfputil.read_porttab_mappings(port_config_file_path, 0)
 
+        self._init_led_queue()
+
         led_type = platform_ndk_pb2.ReqLedType.LED_TYPE_PORT
         led_info = nokia_common.led_color_to_info(DeviceBase.STATUS_LED_COLOR_OFF)
         channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_LED_SERVICE)
@@ -53,6 +63,138 @@ class LedControlCommon(led_control_base.LedControlBase):
                 platform_ndk_pb2.ReqLedInfoPb(led_type=led_type,
                                               led_idx=port_idx, led_info=led_info))
         nokia_common.channel_shutdown(channel)
+        if ret:
+            for port_id in range(nokia_common.NOKIA_FP_START_PORTID, nokia_common.NOKIA_FP_END_PORTID + 1):
+                self.led_applied[port_id] = DeviceBase.STATUS_LED_COLOR_OFF
+
+    def _init_led_queue(self):
+        # port_id -> (color, time of the first queued event)
+        self.led_pending = {}
+        # port_id -> color last sent successfully
+        self.led_applied = {}
+        # also guards led_stats, updated by both threads
+        self.led_cond = threading.Condition()
+        self.led_stats = {'events': 0, 'rpcs': 0, 'rpc_failures': 0, 'ports_sent': 0,
+                          'suppressed': 0, 'latency_max_ms': 0.0, 'latency_sum_ms': 0.0}
+        self.led_stats_logged = dict(self.led_stats)
+        self.led_stats_log_time = time.monotonic()
+        self.led_thread = threading.Thread(target=self._led_flush_loop, name='led-flush', daemon=True)
+        self.led_thread.start()
+
+    def _led_flush_loop(self):
+        while True:
+            with self.led_cond:
+                while not self.led_pending:
+                    self.led_cond.wait(LED_STATS_LOG_SECS)
+                    self._log_led_stats()
+            # let the rest of a flap storm arrive
+            time.sleep(LED_COALESCE_SECS)
+            with self.led_cond:
+                pending = self.led_pending
+                self.led_pending = {}
+            failed = self._flush_leds(pending)
+            if failed:
+                with self.led_cond:
+                    for port_id, entry in failed.items():
+                        # unless a newer event replaced it meanwhile
+                        self.led_pending.setdefault(port_id, entry)
+                time.sleep(LED_RETRY_SECS)
+            self._log_led_stats()
+
+    @staticmethod
+    def _port_ranges(port_ids):
+        ranges = []
+        for port_id in sorted(port_ids):
+            if ranges and ranges[-1][1] == port_id - 1:
+                ranges[-1][1] = port_id
+            else:
+                ranges.append([port_id, port_id])
+        return ranges
+
+    def _flush_leds(self, pending):
+        """
+        Sends the pending port colors, returns the entries of the ports
+        that could not be updated
+        """
+        stats = dict.fromkeys(('rpcs', 'rpc_failures', 'ports_sent', 'suppressed', 'latency_sum_ms'), 0)
+        stats['latency_max_ms'] = 0.0
+        failed = {}
+        try:
+            self._send_leds(pending, stats, failed)
+        finally:
+            with self.led_cond:
+                for key, value in stats.items():
+                    if key == 'latency_max_ms':
+                        self.led_stats[key] = max(self.led_stats[key], value)
+                    else:
+                        self.led_stats[key] += value
+        return failed
+
+    def _send_leds(self, pending, stats, failed):
+        by_color = {}
+        for port_id, (color, queued) in pending.items():
+            if self.led_applied.get(port_id) == color:
+                # flapped back to the state already shown
+                stats['suppressed'] += 1
+                continue
+            by_color.setdefault(color, []).append(port_id)
+        if not by_color:
+            return
+
+        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_LED_SERVICE)
+        if not channel or not stub:
+            stats['rpc_failures'] += 1
+            for port_ids in by_color.values():
+                for port_id in port_ids:
+                    failed[port_id] = pending[port_id]
+            return
+
+        led_type = platform_ndk_pb2.ReqLedType.LED_TYPE_PORT
+        for color, port_ids in by_color.items():
+            led_info = nokia_common.led_color_to_info(color)
+            for start_idx, end_idx in self._port_ranges(port_ids):
+                port_idx = platform_ndk_pb2.ReqLedIndexPb(start_idx=start_idx, end_idx=end_idx)
+                ret, response = nokia_common.try_grpc(stub.SetLed,
+                        platform_ndk_pb2.ReqLedInfoPb(led_type=led_type,
+                                                      led_idx=port_idx, led_info=led_info))
+                stats['rpcs'] += 1
+                if not ret:
+                    stats['rpc_failures'] += 1
+                    logger.log_warning('SetLed ports {}-{} {} failed'.format(start_idx, end_idx, color))
+                    for port_id in range(start_idx, end_idx + 1):
+                        failed[port_id] = pending[port_id]
+                    continue
+                now = time.monotonic()
+                for port_id in range(start_idx, end_idx + 1):
+                    self.led_applied[port_id] = color
+                    latency = (now - pending[port_id][1]) * 1000
+                    stats['ports_sent'] += 1
+                    stats['latency_sum_ms'] += latency
+                    stats['latency_max_ms'] = max(stats['latency_max_ms'], latency)
+        nokia_common.channel_shutdown(channel)
+
+    def _log_led_stats(self):
+        now = time.monotonic()
+        if now - self.led_stats_log_time < LED_STATS_LOG_SECS:
+            return
+        self.led_stats_log_time = now
+        with self.led_cond:
+            if self.led_stats == self.led_stats_logged:
+                return
+            self.led_stats_logged = dict(self.led_stats)
+        logger.log_info('LED updates: {}'.format(self.get_led_stats()))
+
+    def get_led_stats(self):
+        """
+        Counters of the port LED queue: link events received, SetLed RPCs
+        sent, ports updated and the event to LED update latency
+        """
+        with self.led_cond:
+            stats = dict(self.led_stats)
+        latency_sum = stats.pop('latency_sum_ms')
+        stats['latency_avg_ms'] = round(latency_sum / stats['ports_sent'], 1) if stats['ports_sent'] else 0.0
+        stats['latency_max_ms'] = round(stats['latency_max_ms'], 1)
+        return stats
 
     def port_link_state_change(self, port, state):
         intf_prefix = 'Ethernet'
@@ -72,20 +214,17 @@ class LedControlCommon(led_control_base.LedControlBase):
         else:
             return
 
-        led_type = platform_ndk_pb2.ReqLedType.LED_TYPE_PORT
         if port_up:
-            led_info = nokia_common.led_color_to_info(DeviceBase.STATUS_LED_COLOR_GREEN)
+            color = DeviceBase.STATUS_LED_COLOR_GREEN
         else:
-            led_info = nokia_common.led_color_to_info(DeviceBase.STATUS_LED_COLOR_OFF)
+            color = DeviceBase.STATUS_LED_COLOR_OFF
 
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_LED_SERVICE)
-        if not channel or not stub:
-            return
-        port_idx = platform_ndk_pb2.ReqLedIndexPb(start_idx=port_id, end_idx=port_id)
-        ret, response = nokia_common.try_grpc(stub.SetLed,
-                platform_ndk_pb2.ReqLedInfoPb(led_type=led_type,
-                                              led_idx=port_idx, led_info=led_info))
-        nokia_common.channel_shutdown(channel)
+        # queued for _led_flush_loop(), the last state of a port wins
+        with self.led_cond:
+            self.led_stats['events'] += 1
+            queued = self.led_pending.get(port_id, (None, time.monotonic()))[1]
+            self.led_pending[port_id] = (color, queued)
+            self.led_cond.notify()
 
 
 def getLedControl():
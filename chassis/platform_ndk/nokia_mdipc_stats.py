@@ -0,0 +1,363 @@
+# Name: nokia_mdipc_stats.py, version: 1.0
+#
+# Description: Module contains the shared memory statistics of the
+# Module Direct IPC (MDIPC) transceiver client for Nokia IXR7250 platform.
+#
+# Every process using MDIPC owns one statistics file.  The file is a flat
+# array of native 64-bit counters so that 'nokia_cmd show mdipc-stats' can
+# read and merge all processes without signalling them.  The owner holds an
+# flock on its file for its lifetime: the host and pmon share the directory
+# but not the pid namespace, so a file nobody holds a lock on is stale.
+# A forked child drops the inherited file, which would otherwise keep the
+# lock of an exited parent, and opens its own on first use.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import bisect
+import fcntl
+import glob
+import mmap
+import os
+import threading
+import time
+import weakref
+
+MDIPC_STATS_DIR = os.environ.get('NOKIA_MDIPC_STATS_DIR', '/var/run/redis/')
+MDIPC_STATS_PREFIX = 'nokia_mdipc_stats.'
+MDIPC_STATS_MAGIC = 0x4D44495053544154
+MDIPC_STATS_VERSION = 2
+
+MDIPC_STATS_MAX_CHANNELS = 8
+
+# op classes
+STAT_OP_READ = 0
+STAT_OP_WRITE = 1
+STAT_OP_PRESENCE = 2
+STAT_OP_NAMES = ('read', 'write', 'presence')
+
+# request classes, in priority order, see MDIPC_CLASS_CHANNELS in sfp.py
+REQ_CLASS_CONTROL = 0
+REQ_CLASS_PRESENCE = 1
+REQ_CLASS_DOM = 2
+REQ_CLASS_BULK = 3
+REQ_CLASS_NAMES = ('control', 'presence', 'dom', 'bulk')
+
+# page classes
+PAGE_CLASS_LOWER = 0
+PAGE_CLASS_UPPER = 1
+PAGE_CLASS_LANE = 2
+PAGE_CLASS_CDB = 3
+PAGE_CLASS_NAMES = ('lower', 'upper', 'lane', 'cdb')
+
+# histogram bucket upper bounds in microseconds, plus one overflow bucket
+HIST_BOUNDS_US = (50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000,
+                  50000, 100000, 200000, 500000, 1000000)
+HIST_NUM_BUCKETS = len(HIST_BOUNDS_US) + 1
+# each histogram is buckets followed by sum and max (usecs)
+HIST_SUM = HIST_NUM_BUCKETS
+HIST_MAX = HIST_NUM_BUCKETS + 1
+HIST_SIZE = HIST_NUM_BUCKETS + 2
+
+CHAN_COUNTERS = ('msgs', 'success', 'fail', 'notpresent', 'unknown',
+                 'timeouts', 'long_rsp', 'already_in_use')
+(CHAN_MSGS, CHAN_SUCCESS, CHAN_FAIL, CHAN_NOTPRESENT, CHAN_UNKNOWN,
+ CHAN_TIMEOUTS, CHAN_LONG_RSP, CHAN_ALREADY_IN_USE) = range(len(CHAN_COUNTERS))
+GLOBAL_COUNTERS = ('no_channel_avail',) + tuple('no_channel_' + name for name in REQ_CLASS_NAMES)
+GLOBAL_NO_CHANNEL_AVAIL = 0
+# followed by the no_channel_avail count of each request class
+GLOBAL_NO_CHANNEL_CLASS = 1
+
+# layout in 64-bit words
+HDR_MAGIC = 0
+HDR_VERSION = 1
+HDR_PID = 2
+HDR_START_NS = 3
+HDR_UPDATE_NS = 4
+HDR_SIZE = 8
+
+GLOBAL_BASE = HDR_SIZE
+GLOBAL_SIZE = 8
+CHAN_BASE = GLOBAL_BASE + GLOBAL_SIZE
+CHAN_SIZE = len(CHAN_COUNTERS)
+RSP_HIST_BASE = CHAN_BASE + (MDIPC_STATS_MAX_CHANNELS * CHAN_SIZE)
+RSP_HIST_COUNT = MDIPC_STATS_MAX_CHANNELS * len(STAT_OP_NAMES) * len(PAGE_CLASS_NAMES)
+WAIT_HIST_BASE = RSP_HIST_BASE + (RSP_HIST_COUNT * HIST_SIZE)
+WAIT_HIST_COUNT = len(STAT_OP_NAMES)
+CLASS_WAIT_HIST_BASE = WAIT_HIST_BASE + (WAIT_HIST_COUNT * HIST_SIZE)
+CLASS_WAIT_HIST_COUNT = len(REQ_CLASS_NAMES)
+MDIPC_STATS_WORDS = CLASS_WAIT_HIST_BASE + (CLASS_WAIT_HIST_COUNT * HIST_SIZE)
+MDIPC_STATS_FILE_SIZE = MDIPC_STATS_WORDS * 8
+
+
+# writers of this process, closed in a forked child
+_writers = weakref.WeakSet()
+
+
+def page_class(page):
+    if page == 0:
+        return PAGE_CLASS_LOWER
+    if 16 <= page <= 31:
+        # CMIS banked lane control/status pages
+        return PAGE_CLASS_LANE
+    if page >= 159:
+        return PAGE_CLASS_CDB
+    return PAGE_CLASS_UPPER
+
+
+def hist_bucket(usecs):
+    return bisect.bisect_left(HIST_BOUNDS_US, usecs)
+
+
+def rsp_hist_offset(chan, op, pclass):
+    index = (chan * len(STAT_OP_NAMES) + op) * len(PAGE_CLASS_NAMES) + pclass
+    return RSP_HIST_BASE + index * HIST_SIZE
+
+
+def wait_hist_offset(op):
+    return WAIT_HIST_BASE + op * HIST_SIZE
+
+
+def class_wait_hist_offset(req_class):
+    return CLASS_WAIT_HIST_BASE + req_class * HIST_SIZE
+
+
+class MdipcStats():
+    """
+    Writer side, one instance per process
+    """
+
+    def __init__(self, stats_dir=MDIPC_STATS_DIR):
+        self.pid = os.getpid()
+        self.words = None
+        self.fd = None
+        # read-modify-write of the counters by the MDIPC threads
+        self.lock = threading.Lock()
+        self._prune(stats_dir)
+
+        try:
+            self.path, self.fd = self._open_locked(stats_dir)
+            os.ftruncate(self.fd, 0)
+            os.ftruncate(self.fd, MDIPC_STATS_FILE_SIZE)
+            self.mm = mmap.mmap(self.fd, MDIPC_STATS_FILE_SIZE)
+        except OSError:
+            if self.fd is not None:
+                os.close(self.fd)
+                self.fd = None
+            self.mm = None
+            return
+
+        self.words = memoryview(self.mm).cast('Q')
+        self.words[HDR_VERSION] = MDIPC_STATS_VERSION
+        self.words[HDR_PID] = self.pid
+        self.words[HDR_START_NS] = time.time_ns()
+        self.words[HDR_UPDATE_NS] = time.time_ns()
+        # magic last: readers ignore files still being set up
+        self.words[HDR_MAGIC] = MDIPC_STATS_MAGIC
+        _writers.add(self)
+
+    def _open_locked(self, stats_dir):
+        """
+        Returns (path, fd) of a statistics file locked by this process.  A
+        process of the other pid namespace may own the file of our pid.
+        """
+        base = stats_dir + MDIPC_STATS_PREFIX + str(self.pid)
+        for n in range(8):
+            path = base if n == 0 else '{}-{}'.format(base, n)
+            fd = os.open(path, os.O_RDWR | os.O_CREAT | os.O_NOFOLLOW | os.O_CLOEXEC, 0o644)
+            try:
+                fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+                # pruned between open and lock
+                if os.fstat(fd).st_ino == os.stat(path).st_ino:
+                    return path, fd
+            except OSError:
+                pass
+            os.close(fd)
+        raise OSError('no free statistics file for pid {}'.format(self.pid))
+
+    def _prune(self, stats_dir):
+        # files whose owner is gone, in any pid namespace
+        for path in glob.glob(stats_dir + MDIPC_STATS_PREFIX + '*'):
+            try:
+                fd = os.open(path, os.O_RDONLY | os.O_NOFOLLOW | os.O_CLOEXEC)
+            except OSError:
+                continue
+            try:
+                fcntl.flock(fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
+                os.unlink(path)
+            except OSError:
+                pass
+            finally:
+                os.close(fd)
+
+    def count(self, chan, counter, val=1):
+        if self.words is None:
+            return
+        with self.lock:
+            self.words[CHAN_BASE + chan * CHAN_SIZE + counter] += val
+
+    def count_global(self, counter, val=1):
+        if self.words is None:
+            return
+        with self.lock:
+            self.words[GLOBAL_BASE + counter] += val
+
+    def _record(self, base, usecs):
+        words = self.words
+        with self.lock:
+            words[base + hist_bucket(usecs)] += 1
+            words[base + HIST_SUM] += usecs
+            if usecs > words[base + HIST_MAX]:
+                words[base + HIST_MAX] = usecs
+            words[HDR_UPDATE_NS] = time.time_ns()
+
+    def record_rsp(self, chan, op, page, usecs):
+        if self.words is None:
+            return
+        self._record(rsp_hist_offset(chan, op, page_class(page)), max(usecs, 0))
+
+    def record_wait(self, op, usecs):
+        if self.words is None:
+            return
+        self._record(wait_hist_offset(op), max(usecs, 0))
+
+    def record_class_wait(self, req_class, usecs, obtained=True):
+        if self.words is None:
+            return
+        self._record(class_wait_hist_offset(req_class), max(usecs, 0))
+        if not obtained:
+            with self.lock:
+                self.words[GLOBAL_BASE + GLOBAL_NO_CHANNEL_CLASS + req_class] += 1
+
+    def close(self, unlink=True):
+        if self.words is None:
+            return
+        self.words.release()
+        self.words = None
+        self.mm.close()
+        if unlink:
+            try:
+                os.unlink(self.path)
+            except OSError:
+                pass
+        os.close(self.fd)
+        self.fd = None
+
+
+def _after_fork_in_child():
+    # the parent's file stays, without the lock reference of this child
+    for writer in list(_writers):
+        writer.close(unlink=False)
+    _writers.clear()
+
+
+os.register_at_fork(after_in_child=_after_fork_in_child)
+
+
+class MdipcStatsSnapshot():
+    """
+    Reader side: merged copy of one or more statistics files
+    """
+
+    def __init__(self):
+        self.words = [0] * MDIPC_STATS_WORDS
+        self.processes = []
+
+    def merge_file(self, path):
+        try:
+            with open(path, 'rb') as f:
+                raw = f.read(MDIPC_STATS_FILE_SIZE)
+        except OSError:
+            return False
+        if len(raw) != MDIPC_STATS_FILE_SIZE:
+            return False
+        words = memoryview(raw).cast('Q')
+        if (words[HDR_MAGIC] != MDIPC_STATS_MAGIC) or (words[HDR_VERSION] != MDIPC_STATS_VERSION):
+            return False
+
+        self.processes.append({'pid': words[HDR_PID],
+                               'start_ns': words[HDR_START_NS],
+                               'update_ns': words[HDR_UPDATE_NS],
+                               'msgs': sum(words[CHAN_BASE + c * CHAN_SIZE] for c in range(MDIPC_STATS_MAX_CHANNELS))})
+        for i in range(HDR_SIZE, MDIPC_STATS_WORDS):
+            if ((i >= RSP_HIST_BASE) and ((i - RSP_HIST_BASE) % HIST_SIZE == HIST_MAX)):
+                self.words[i] = max(self.words[i], words[i])
+            else:
+                self.words[i] += words[i]
+        return True
+
+    def chan_counter(self, chan, counter):
+        return self.words[CHAN_BASE + chan * CHAN_SIZE + counter]
+
+    def global_counter(self, counter):
+        return self.words[GLOBAL_BASE + counter]
+
+    def rsp_hist(self, op, pclass, chan=None):
+        chans = range(MDIPC_STATS_MAX_CHANNELS) if chan is None else [chan]
+        hist = [0] * HIST_SIZE
+        for c in chans:
+            base = rsp_hist_offset(c, op, pclass)
+            for i in range(HIST_SIZE):
+                if i == HIST_MAX:
+                    hist[i] = max(hist[i], self.words[base + i])
+                else:
+                    hist[i] += self.words[base + i]
+        return hist
+
+    def wait_hist(self, op):
+        base = wait_hist_offset(op)
+        return self.words[base:base + HIST_SIZE]
+
+    def class_wait_hist(self, req_class):
+        base = class_wait_hist_offset(req_class)
+        return self.words[base:base + HIST_SIZE]
+
+    def class_no_channel(self, req_class):
+        return self.words[GLOBAL_BASE + GLOBAL_NO_CHANNEL_CLASS + req_class]
+
+
+def hist_count(hist):
+    return sum(hist[0:HIST_NUM_BUCKETS])
+
+
+def hist_percentile(hist, pct):
+    """
+    Upper bound (usecs) of the bucket holding the pct percentile, the max
+    seen for the overflow bucket
+    """
+    total = hist_count(hist)
+    if total == 0:
+        return 0
+    target = total * pct / 100.0
+    seen = 0
+    for i in range(HIST_NUM_BUCKETS):
+        seen += hist[i]
+        if seen >= target:
+            if i < len(HIST_BOUNDS_US):
+                return min(HIST_BOUNDS_US[i], hist[HIST_MAX])
+            return hist[HIST_MAX]
+    return hist[HIST_MAX]
+
+
+def hist_to_dict(hist):
+    count = hist_count(hist)
+    buckets = {}
+    for i in range(HIST_NUM_BUCKETS):
+        if i < len(HIST_BOUNDS_US):
+            buckets['le_' + str(HIST_BOUNDS_US[i])] = hist[i]
+        else:
+            buckets['gt_' + str(HIST_BOUNDS_US[-1])] = hist[i]
+    return {'count': count,
+            'avg_us': (hist[HIST_SUM] // count) if count else 0,
+            'p50_us': hist_percentile(hist, 50),
+            'p99_us': hist_percentile(hist, 99),
+            'max_us': hist[HIST_MAX],
+            'buckets': buckets}
+
+
+def collect(stats_dir=MDIPC_STATS_DIR):
+    snapshot = MdipcStatsSnapshot()
+    for path in sorted(glob.glob(stats_dir + MDIPC_STATS_PREFIX + '*')):
+        snapshot.merge_file(path)
+    return snapshot
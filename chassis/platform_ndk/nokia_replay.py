@@ -0,0 +1,351 @@
+# Name: nokia_replay.py, version: 1.0
+#
+# Description: Record and replay of a process' platform NDK traffic, to
+# reproduce pmon performance problems (slow chassisd cycles, xcvrd stalls)
+# off the chassis and to measure client side changes on identical traffic.
+#
+# NOKIA_NDK_RECORD=<dir> makes every process using platform_ndk append
+# each unary RPC on its NDK channels and each MDIPC exchange of
+# sonic_platform/sfp.py, with the serialized request and response and its
+# duration, to <dir>/<process>-<pid>.jsonl.
+#
+# NOKIA_NDK_REPLAY=<file> answers from such a capture instead of the NDK:
+# nokia_common hands out a local channel to the unmodified stubs and MDIPC
+# exchanges bypass the shared memory channels. Identical requests get the
+# recorded answers in order, the last one repeated once they run out;
+# requests not in the capture fail as if the NDK were down. Each answer is
+# delayed by its recorded duration divided by NOKIA_NDK_REPLAY_SPEED
+# (default 1, 0 answers at once), e.g.
+#
+#   NOKIA_NDK_RECORD=/tmp/ndk supervisorctl restart xcvrd    (in pmon)
+#   NOKIA_NDK_REPLAY=/tmp/ndk/xcvrd-87.jsonl NOKIA_NDK_REPLAY_SPEED=10 \
+#       python3 mdipc_bench.py --workload xcvrd --duration 30
+#   NOKIA_NDK_REPLAY=/tmp/ndk/chassisd-85.jsonl python3 ndk_loadgen.py --mix chassisd
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import atexit
+import base64
+import collections
+import json
+import os
+import sys
+import threading
+import time
+from concurrent import futures
+
+import grpc
+from sonic_py_common.logger import Logger
+
+NOKIA_NDK_CAPTURE_VERSION = 1
+NOKIA_NDK_REPLAY_WORKERS = 8
+
+KIND_HEADER = 'header'
+KIND_RPC = 'rpc'
+KIND_MDIPC = 'mdipc'
+
+logger = Logger("nokia_replay")
+
+_record_dir = os.environ.get('NOKIA_NDK_RECORD')
+_replay_file = os.environ.get('NOKIA_NDK_REPLAY')
+try:
+    _replay_speed = float(os.environ.get('NOKIA_NDK_REPLAY_SPEED', '1'))
+except ValueError:
+    _replay_speed = 1.0
+
+_lock = threading.Lock()
+# capture file of this process, re-opened in a forked child
+_record_file = None
+_record_pid = None
+_record_start = None
+_replay = None
+
+
+def recording():
+    return _record_dir is not None and _replay_file is None
+
+
+def replaying():
+    return _replay_file is not None
+
+
+def _b64(data):
+    if data is None:
+        return None
+    return base64.b64encode(bytes(data)).decode()
+
+
+def _serialize(message):
+    if message is None or not hasattr(message, 'SerializeToString'):
+        return None
+    return _b64(message.SerializeToString())
+
+
+def _record(entry):
+    global _record_dir, _record_file, _record_pid, _record_start
+    with _lock:
+        if _record_pid != os.getpid():
+            name = os.path.basename(sys.argv[0]) if sys.argv and sys.argv[0] else 'python'
+            path = os.path.join(_record_dir, '{}-{}.jsonl'.format(name, os.getpid()))
+            try:
+                os.makedirs(_record_dir, exist_ok=True)
+                _record_file = open(path, 'w')
+            except OSError as e:
+                logger.log_warning("Unable to record NDK traffic to {}: {}".format(path, e))
+                _record_dir = None
+                return
+            _record_pid = os.getpid()
+            _record_start = time.monotonic()
+            _record_file.write(json.dumps({'kind': KIND_HEADER, 'version': NOKIA_NDK_CAPTURE_VERSION,
+                                           'process': name, 'pid': _record_pid,
+                                           'time': time.time()}) + '\n')
+            logger.log_notice("Recording NDK traffic to {}".format(path))
+        entry['t'] = round(time.monotonic() - _record_start, 6)
+        _record_file.write(json.dumps(entry) + '\n')
+        _record_file.flush()
+
+
+def record_rpc(method, request, response, status, secs):
+    _record({'kind': KIND_RPC, 'method': method, 'req': _serialize(request),
+             'status': status, 'rsp': _serialize(response) if status == 'OK' else None,
+             'secs': round(secs, 6)})
+
+
+def record_mdipc(op, hw_port_id, page, offset, num_bytes, data, status, ret_data, secs):
+    _record({'kind': KIND_MDIPC, 'op': op, 'port': hw_port_id, 'page': page, 'offset': offset,
+             'num_bytes': num_bytes, 'data': _b64(data), 'status': status, 'rsp': _b64(ret_data),
+             'secs': round(secs, 6)})
+
+
+def _rpc_key(method, req):
+    if isinstance(method, bytes):
+        method = method.decode()
+    return (KIND_RPC, method, req)
+
+
+def _mdipc_key(op, hw_port_id, page, offset, num_bytes, data):
+    return (KIND_MDIPC, op, hw_port_id, page, offset, num_bytes, data)
+
+
+def _status_code(status):
+    return getattr(grpc.StatusCode, status, grpc.StatusCode.UNKNOWN)
+
+
+class _RecordingMultiCallable():
+    """
+    Unary RPC of a real channel, records each call
+    """
+    def __init__(self, multi_callable, method):
+        self._callable = multi_callable
+        # nokia_common.try_grpc() passes metadata to callables with _method
+        self._method = method.decode() if isinstance(method, bytes) else method
+
+    def __call__(self, request, *args, **kwargs):
+        start = time.monotonic()
+        try:
+            response = self._callable(request, *args, **kwargs)
+        except grpc.RpcError as e:
+            status = e.code().name if e.code() is not None else 'UNKNOWN'
+            record_rpc(self._method, request, None, status, time.monotonic() - start)
+            raise
+        status = 'OK' if response is not None else 'NO_RESPONSE'
+        record_rpc(self._method, request, response, status, time.monotonic() - start)
+        return response
+
+    def future(self, request, *args, **kwargs):
+        start = time.monotonic()
+        future = self._callable.future(request, *args, **kwargs)
+        future.add_done_callback(lambda f: self._record_future(request, f, start))
+        return future
+
+    def _record_future(self, request, future, start):
+        secs = time.monotonic() - start
+        try:
+            response = future.result()
+        except grpc.RpcError as e:
+            record_rpc(self._method, request, None, e.code().name if e.code() is not None else 'UNKNOWN', secs)
+            return
+        except Exception:
+            record_rpc(self._method, request, None, 'CANCELLED', secs)
+            return
+        record_rpc(self._method, request, response, 'OK' if response is not None else 'NO_RESPONSE', secs)
+
+
+class _RecordingChannel():
+    """
+    Real channel whose unary RPCs are recorded, everything else passes
+    through
+    """
+    def __init__(self, channel):
+        self._channel = channel
+
+    def unary_unary(self, method, *args, **kwargs):
+        return _RecordingMultiCallable(self._channel.unary_unary(method, *args, **kwargs), method)
+
+    def __getattr__(self, name):
+        return getattr(self._channel, name)
+
+
+def record_channel(channel):
+    """
+    Returns the channel to use for channel, recording when enabled
+    """
+    if channel is None or not recording():
+        return channel
+    return _RecordingChannel(channel)
+
+
+class ReplayRpcError(grpc.RpcError):
+    def __init__(self, code, details):
+        super(ReplayRpcError, self).__init__(details)
+        self._code = code
+        self._details = details
+
+    def code(self):
+        return self._code
+
+    def details(self):
+        return self._details
+
+
+class _Replay():
+    def __init__(self, path):
+        self.answers = collections.defaultdict(collections.deque)
+        self.last = {}
+        self.served = 0
+        self.missed = 0
+        self.delay_secs = 0.0
+        self.executor = futures.ThreadPoolExecutor(max_workers=NOKIA_NDK_REPLAY_WORKERS)
+
+        with open(path, 'r') as f:
+            for line in f:
+                entry = json.loads(line)
+                if entry['kind'] == KIND_RPC:
+                    key = _rpc_key(entry['method'], entry['req'])
+                elif entry['kind'] == KIND_MDIPC:
+                    key = _mdipc_key(entry['op'], entry['port'], entry['page'], entry['offset'],
+                                     entry['num_bytes'], entry['data'])
+                else:
+                    continue
+                self.answers[key].append(entry)
+        logger.log_notice("Replaying NDK traffic from {} at speed {}, {} distinct requests".format(
+            path, _replay_speed, len(self.answers)))
+        atexit.register(self.log_stats)
+
+    def answer(self, key):
+        """
+        Returns the next recorded entry for key after its delay, or None
+        """
+        with _lock:
+            queue = self.answers.get(key)
+            if queue:
+                entry = queue.popleft()
+                self.last[key] = entry
+            else:
+                entry = self.last.get(key)
+            if entry is None:
+                self.missed += 1
+                return None
+            self.served += 1
+            delay = entry['secs'] / _replay_speed if _replay_speed > 0 else 0
+            self.delay_secs += delay
+        if delay:
+            time.sleep(delay)
+        return entry
+
+    def get_stats(self):
+        with _lock:
+            return {'served': self.served, 'missed': self.missed, 'delay_secs': round(self.delay_secs, 3),
+                    'speed': _replay_speed}
+
+    def log_stats(self):
+        stats = self.get_stats()
+        logger.log_notice("Replayed {} NDK answers, {} requests not in the capture, {}s NDK time at speed {}".format(
+            stats['served'], stats['missed'], stats['delay_secs'], stats['speed']))
+
+
+def _get_replay():
+    global _replay
+    with _lock:
+        if _replay is None:
+            _replay = _Replay(_replay_file)
+        return _replay
+
+
+class _ReplayMultiCallable():
+    def __init__(self, method, response_deserializer):
+        self._method = method.decode() if isinstance(method, bytes) else method
+        self._deserializer = response_deserializer
+
+    def __call__(self, request, timeout=None, metadata=None, **kwargs):
+        entry = _get_replay().answer(_rpc_key(self._method, _serialize(request)))
+        if entry is None:
+            raise ReplayRpcError(grpc.StatusCode.UNAVAILABLE, '{} not in capture'.format(self._method))
+        if entry['status'] == 'NO_RESPONSE':
+            return None
+        if entry['status'] != 'OK':
+            raise ReplayRpcError(_status_code(entry['status']), 'recorded {}'.format(entry['status']))
+        return self._deserializer(base64.b64decode(entry['rsp']))
+
+    def future(self, request, timeout=None, metadata=None, **kwargs):
+        # answered concurrently like the RPCs of a real channel
+        return _get_replay().executor.submit(self, request)
+
+
+class _ReplayUnsupported():
+    def __init__(self, method, *args, **kwargs):
+        self._method = method
+
+    def __call__(self, *args, **kwargs):
+        raise ReplayRpcError(grpc.StatusCode.UNIMPLEMENTED, 'streaming RPCs are not replayed')
+
+
+class ReplayChannel():
+    """
+    Stands in for a grpc channel, answers unary RPCs from the capture
+    """
+    def unary_unary(self, method, request_serializer=None, response_deserializer=None, **kwargs):
+        return _ReplayMultiCallable(method, response_deserializer)
+
+    unary_stream = _ReplayUnsupported
+    stream_unary = _ReplayUnsupported
+    stream_stream = _ReplayUnsupported
+
+    def subscribe(self, callback, try_to_connect=False):
+        pass
+
+    def unsubscribe(self, callback):
+        pass
+
+    def close(self):
+        pass
+
+
+_replay_channel = ReplayChannel()
+
+
+def replay_channel():
+    return _replay_channel
+
+
+def replay_mdipc(op, hw_port_id, page, offset, num_bytes, data=None):
+    """
+    Returns the recorded (status, ret_data) of an MDIPC exchange, status
+    None if it is not in the capture
+    """
+    entry = _get_replay().answer(_mdipc_key(op, hw_port_id, page, offset, num_bytes, _b64(data)))
+    if entry is None:
+        return None, None
+    ret_data = bytearray(base64.b64decode(entry['rsp'])) if entry['rsp'] is not None else None
+    return entry['status'], ret_data
+
+
+def get_stats():
+    """
+    Returns the replay counters, None unless replaying
+    """
+    if not replaying():
+        return None
+    return _get_replay().get_stats()
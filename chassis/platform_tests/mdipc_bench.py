@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+#
+# Name: mdipc_bench.py, version: 1.0
+#
+# Description: Benchmark of the MDIPC transceiver client in
+# sonic_platform/sfp.py. Runs against the real NDK or against
+# platform_tests/mdipc_sim.py or a platform_ndk/nokia_replay.py capture, e.g.
+#
+#   python3 mdipc_sim.py --base /tmp/mdipc/MDIPC --ports 36 --latency-us 300 &
+#   NOKIA_MDIPC_BASE_NAME=/tmp/mdipc/MDIPC NOKIA_MDIPC_STATS_DIR=/tmp/mdipc/ \
+#       python3 mdipc_bench.py --ports 36 --workload xcvrd --duration 30
+#
+# Workloads:
+#   eeprom   - Sfp.read_eeprom() sweep of the info/DOM areas of every port
+#   raw      - uncached MDIPC reads, measures the channel round trip only
+#   presence - get_presence() sweeps of all ports
+#   xcvrd    - concurrent DOM, info, presence and CMIS-write threads,
+#              plus --cli-threads bulk class readers (show interfaces
+#              transceiver) competing with them
+#
+# Reads use the --read-class request class (default dom, as xcvrd).
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import os
+import threading
+import time
+
+from platform_ndk import nokia_mdipc_stats
+from platform_ndk import nokia_replay
+from platform_ndk import platform_ndk_pb2
+from sonic_platform.sfp import Sfp, MDIPC_READ, MDIPC_CLASS_BULK
+
+# (offset, num_bytes) in the flat optoe address space used by read_eeprom()
+INFO_READS = [(0, 1), (1, 2), (128, 128), (256 + 0, 128), (384 + 0, 128)]
+DOM_READS = [(14, 2), (16, 2), (9, 3), (2304, 64)]
+CMIS_WRITE = (2176 + 4, 1)
+
+
+class Recorder():
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.samples = {}
+        self.errors = {}
+
+    def timed(self, name, func, *args):
+        start = time.monotonic_ns()
+        ret = func(*args)
+        usecs = (time.monotonic_ns() - start) // 1000
+        with self.lock:
+            self.samples.setdefault(name, []).append(usecs)
+            if ret is None or ret is False:
+                self.errors[name] = self.errors.get(name, 0) + 1
+        return ret
+
+    def report(self, elapsed):
+        print('{:<12} {:>9} {:>10} {:>9} {:>9} {:>9} {:>9} {:>7}'.format(
+            'call', 'count', 'rate/s', 'p50(us)', 'p90(us)', 'p99(us)', 'max(us)', 'errors'))
+        for name in sorted(self.samples):
+            lat = sorted(self.samples[name])
+            count = len(lat)
+
+            def pct(p):
+                return lat[min(count - 1, int(count * p / 100.0))]
+            print('{:<12} {:>9} {:>10.1f} {:>9} {:>9} {:>9} {:>9} {:>7}'.format(
+                name, count, count / elapsed, pct(50), pct(90), pct(99), lat[-1], self.errors.get(name, 0)))
+
+
+def create_sfps(num_ports):
+    Sfp.alloc_port_tables(num_ports)
+    sfp_type = platform_ndk_pb2.RespSfpModuleType.SFP_MODULE_TYPE_QSFPDD
+    return [Sfp(index, sfp_type, None) for index in range(1, num_ports + 1)]
+
+
+def run_eeprom(sfps, rec, deadline):
+    while time.monotonic() < deadline:
+        for sfp in sfps:
+            for offset, num_bytes in INFO_READS + DOM_READS:
+                rec.timed('read_eeprom', sfp.read_eeprom, offset, num_bytes)
+
+
+def run_raw(sfps, rec, deadline):
+    while time.monotonic() < deadline:
+        for sfp in sfps:
+            rec.timed('msg_send', lambda: Sfp.MDIPC_hdl.msg_send(MDIPC_READ, sfp.index, 0, 0, 128)[1])
+
+
+def run_presence(sfps, rec, deadline, interval=0):
+    def sweep():
+        for sfp in sfps:
+            rec.timed('presence', sfp.get_presence)
+        return True
+
+    while time.monotonic() < deadline:
+        start = time.monotonic()
+        rec.timed('sweep', sweep)
+        if interval:
+            time.sleep(max(0, interval - (time.monotonic() - start)))
+
+
+def run_dom(sfps, rec, deadline, interval):
+    while time.monotonic() < deadline:
+        start = time.monotonic()
+        for sfp in sfps:
+            if not sfp.get_presence():
+                continue
+            for offset, num_bytes in DOM_READS:
+                rec.timed('dom', sfp.read_eeprom, offset, num_bytes)
+        time.sleep(max(0, interval - (time.monotonic() - start)))
+
+
+def run_info(sfps, rec, deadline, interval):
+    while time.monotonic() < deadline:
+        for sfp in sfps:
+            sfp.page_cache_flush()
+            for offset, num_bytes in INFO_READS:
+                rec.timed('info', sfp.read_eeprom, offset, num_bytes)
+        time.sleep(interval)
+
+
+def run_cmis(sfps, rec, deadline, interval):
+    offset, num_bytes = CMIS_WRITE
+    while time.monotonic() < deadline:
+        for sfp in sfps:
+            rec.timed('cmis_write', sfp.write_eeprom, offset, num_bytes, bytearray([0x0f]))
+        time.sleep(interval)
+
+
+def run_cli(sfps, rec, deadline):
+    # uncached full page dumps of every port
+    while time.monotonic() < deadline:
+        for sfp in sfps:
+            for page, offset in ((0, 0), (0, 128), (1, 128), (2, 128)):
+                rec.timed('cli_read', lambda: Sfp.MDIPC_hdl.msg_send(MDIPC_READ, sfp.index, page, offset, 128,
+                                                                     req_class=MDIPC_CLASS_BULK)[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MDIPC client benchmark')
+    parser.add_argument('--ports', type=int, default=36)
+    parser.add_argument('--workload', choices=['eeprom', 'raw', 'presence', 'xcvrd'], default='eeprom')
+    parser.add_argument('--duration', type=float, default=10, help='seconds')
+    parser.add_argument('--threads', type=int, default=1, help='parallel threads for eeprom/raw/presence')
+    parser.add_argument('--dom-interval', type=float, default=1.0, help='xcvrd DOM sweep period')
+    parser.add_argument('--info-interval', type=float, default=5.0, help='xcvrd info refresh period')
+    parser.add_argument('--cmis-interval', type=float, default=2.0, help='xcvrd CMIS write period')
+    parser.add_argument('--cli-threads', type=int, default=0, help='xcvrd bulk class CLI readers')
+    parser.add_argument('--read-class', choices=nokia_mdipc_stats.REQ_CLASS_NAMES, default='dom',
+                        help='request class of the reads')
+    args = parser.parse_args()
+
+    sfps = create_sfps(args.ports)
+    Sfp.MDIPC_hdl.read_class = nokia_mdipc_stats.REQ_CLASS_NAMES.index(args.read_class)
+    rec = Recorder()
+    deadline = time.monotonic() + args.duration
+
+    if args.workload == 'xcvrd':
+        jobs = [(run_dom, (sfps, rec, deadline, args.dom_interval)),
+                (run_info, (sfps, rec, deadline, args.info_interval)),
+                (run_presence, (sfps, rec, deadline, 1.0)),
+                (run_cmis, (sfps, rec, deadline, args.cmis_interval))]
+        jobs += [(run_cli, (sfps, rec, deadline))] * args.cli_threads
+    else:
+        func = {'eeprom': run_eeprom, 'raw': run_raw, 'presence': run_presence}[args.workload]
+        jobs = [(func, (sfps, rec, deadline))] * args.threads
+
+    cpu_start = os.times()
+    start = time.monotonic()
+    threads = [threading.Thread(target=func, args=fargs) for func, fargs in jobs]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+    cpu_end = os.times()
+
+    cpu = (cpu_end.user - cpu_start.user) + (cpu_end.system - cpu_start.system)
+    print('workload {} ports {} elapsed {:.1f}s client cpu {:.2f}s ({:.0f}%)'.format(
+        args.workload, args.ports, elapsed, cpu, 100.0 * cpu / elapsed))
+    rec.report(elapsed)
+
+    replay = nokia_replay.get_stats()
+    if replay:
+        print('replay speed {} answers {} not in capture {} ndk time {}s'.format(
+            replay['speed'], replay['served'], replay['missed'], replay['delay_secs']))
+        return
+
+    snapshot = nokia_mdipc_stats.collect()
+    print('no_channel_avail {}'.format(snapshot.global_counter(nokia_mdipc_stats.GLOBAL_NO_CHANNEL_AVAIL)))
+    for op in range(len(nokia_mdipc_stats.STAT_OP_NAMES)):
+        wait = nokia_mdipc_stats.hist_to_dict(snapshot.wait_hist(op))
+        if wait['count']:
+            print('queue wait {:<9} count {} p50 {}us p99 {}us max {}us'.format(
+                nokia_mdipc_stats.STAT_OP_NAMES[op], wait['count'], wait['p50_us'], wait['p99_us'], wait['max_us']))
+    for req_class in range(len(nokia_mdipc_stats.REQ_CLASS_NAMES)):
+        wait = nokia_mdipc_stats.hist_to_dict(snapshot.class_wait_hist(req_class))
+        if wait['count']:
+            print('class wait {:<9} count {} p50 {}us p99 {}us max {}us no channel {}'.format(
+                nokia_mdipc_stats.REQ_CLASS_NAMES[req_class], wait['count'], wait['p50_us'], wait['p99_us'],
+                wait['max_us'], snapshot.class_no_channel(req_class)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+#
+# Name: mdipc_sim.py, version: 1.0
+#
+# Description: Standalone Module Direct IPC (MDIPC) responder. It plays the
+# NDK side of the transceiver channels used by sonic_platform/sfp.py so
+# the client can be tested and benchmarked without IXR 7250 hardware.
+#
+# Usage:
+#   python3 mdipc_sim.py --base /tmp/mdipc/MDIPC --ports 36 --type cmis \
+#       --latency-us 300 --jitter-us 100 --hotplug-interval 5
+#   NOKIA_MDIPC_BASE_NAME=/tmp/mdipc/MDIPC <client>
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import mmap
+import os
+import random
+import signal
+import sys
+import time
+
+# channel protocol, must match sonic_platform/sfp.py
+MDIPC_NUM_CHANNELS = 6
+MDIPC_CHAN_SIZE = 4096
+
+MDIPC_OWN_NDK = 0x5A5A3C3C
+MDIPC_OWN_NOS = 0X43211234
+MDIPC_OWN_NOS_PREP = 0XDEADBEEF
+MDIPC_OWN_NOS_RSP = 0xCBCBAF5F
+
+MDIPC_READ = 0
+MDIPC_WRITE = 1
+MDIPC_PRESENCE = 2
+MDIPC_PRESENCE_BULK = 3
+MDIPC_RSP_SUCCESS = 0
+MDIPC_RSP_FAIL = 1
+MDIPC_RSP_NOTPRESENT = 2
+
+OFF_OWN = 0
+OFF_MSGID = 4
+OFF_OWNER = 8
+OFF_PORT = 12
+OFF_OP = 16
+OFF_PAGE = 20
+OFF_OFFSET = 24
+OFF_NUM_BYTES = 28
+OFF_STATUS = 32
+OFF_DATA = 36
+
+SFF8636_ID_QSFP28 = 0x11
+CMIS_ID_QSFPDD = 0x18
+
+
+def _u32(mm, off):
+    return int.from_bytes(mm[off:off + 4], sys.byteorder)
+
+
+def _put_u32(mm, off, val):
+    mm[off:off + 4] = val.to_bytes(4, sys.byteorder)
+
+
+def _put_str(page, off, length, text):
+    page[off:off + length] = text.encode('ascii').ljust(length)[:length]
+
+
+class Transceiver():
+    """
+    Synthetic EEPROM image of one module, pages of 128 bytes with page 0
+    holding both the lower and the upper half
+    """
+
+    def __init__(self, port, xcvr_type):
+        self.port = port
+        self.xcvr_type = xcvr_type
+        self.pages = {0: bytearray(256)}
+        lower = self.pages[0]
+        serial = 'SIM{:05d}'.format(port)
+        if xcvr_type == 'cmis':
+            lower[0] = CMIS_ID_QSFPDD
+            lower[1] = 0x50                 # CMIS 5.0
+            lower[2] = 0x00                 # paged memory
+            lower[3] = 0x06                 # module state ready
+            lower[85] = 0x01                # media type: MMF
+            _put_str(lower, 129, 16, 'NOKIA-SIM')
+            _put_str(lower, 148, 16, 'SIM-400G-DR4')
+            _put_str(lower, 164, 2, 'A1')
+            _put_str(lower, 166, 16, serial)
+            _put_str(lower, 182, 8, '26010100')
+            lower[128] = CMIS_ID_QSFPDD
+            for page in (0x01, 0x02, 0x10, 0x11):
+                self.pages[page] = bytearray(128)
+            self.temp_off = 14
+            self.vcc_off = 16
+        else:
+            lower[0] = SFF8636_ID_QSFP28
+            lower[1] = 0x07
+            lower[2] = 0x04                 # flat memory not set, data ready
+            _put_str(lower, 148, 16, 'NOKIA-SIM')
+            _put_str(lower, 168, 16, 'SIM-100G-LR4')
+            _put_str(lower, 184, 2, 'A1')
+            _put_str(lower, 196, 16, serial)
+            _put_str(lower, 212, 8, '260101  ')
+            lower[128] = SFF8636_ID_QSFP28
+            for page in (0x01, 0x02, 0x03):
+                self.pages[page] = bytearray(128)
+            self.temp_off = 22
+            self.vcc_off = 26
+        self.update_dom()
+
+    def update_dom(self):
+        lower = self.pages[0]
+        temp = int((35.0 + random.uniform(-1.0, 1.0)) * 256)
+        vcc = int((3.3 + random.uniform(-0.02, 0.02)) * 10000)
+        lower[self.temp_off:self.temp_off + 2] = temp.to_bytes(2, 'big', signed=True)
+        lower[self.vcc_off:self.vcc_off + 2] = vcc.to_bytes(2, 'big')
+
+    def _locate(self, page, offset, num_bytes):
+        if page == 0:
+            data = self.pages[0]
+            start = offset
+            end = 256
+        else:
+            data = self.pages.get(page)
+            if data is None:
+                data = self.pages[page] = bytearray(128)
+            start = offset - 128
+            end = 128
+        if (start < 0) or (start + num_bytes > end):
+            return None, 0
+        return data, start
+
+    def read(self, page, offset, num_bytes):
+        if (page == 0) and (offset < 128):
+            self.update_dom()
+        data, start = self._locate(page, offset, num_bytes)
+        if data is None:
+            return None
+        return bytes(data[start:start + num_bytes])
+
+    def write(self, page, offset, buf):
+        data, start = self._locate(page, offset, len(buf))
+        if data is None:
+            return False
+        data[start:start + len(buf)] = buf
+        return True
+
+
+class Responder():
+    def __init__(self, args):
+        self.args = args
+        self.channels = []
+        self.num_ports = args.ports
+        self.present = [False] + [True] * self.num_ports
+        self.generation = [0] * (self.num_ports + 1)
+        for port in args.absent:
+            if 1 <= port <= self.num_ports:
+                self.present[port] = False
+        self.xcvrs = [None] + [Transceiver(p, args.type) for p in range(1, self.num_ports + 1)]
+        self.stats = {'msgs': 0, 'dropped': 0, 'hotplug': 0}
+        self.next_hotplug = time.monotonic() + args.hotplug_interval if args.hotplug_interval else None
+        self.running = True
+
+    def create_channels(self):
+        base_dir = os.path.dirname(self.args.base)
+        if base_dir:
+            os.makedirs(base_dir, exist_ok=True)
+        for index in range(MDIPC_NUM_CHANNELS):
+            name = self.args.base + str(index)
+            fd = os.open(name, os.O_RDWR | os.O_CREAT | os.O_TRUNC | os.O_NOFOLLOW | os.O_CLOEXEC, 0o666)
+            os.ftruncate(fd, MDIPC_CHAN_SIZE)
+            mm = mmap.mmap(fd, MDIPC_CHAN_SIZE)
+            _put_u32(mm, OFF_OWN, MDIPC_OWN_NOS)
+            self.channels.append((fd, mm))
+        print('mdipc_sim: {} channels at {}0..{} : {} {} ports'.format(
+            MDIPC_NUM_CHANNELS, self.args.base, MDIPC_NUM_CHANNELS - 1, self.num_ports, self.args.type))
+
+    def remove_channels(self):
+        for index, (fd, mm) in enumerate(self.channels):
+            mm.close()
+            os.close(fd)
+            try:
+                os.unlink(self.args.base + str(index))
+            except OSError:
+                pass
+
+    def hotplug(self):
+        if self.args.hotplug_ports:
+            port = random.choice(self.args.hotplug_ports)
+        else:
+            port = random.randint(1, self.num_ports)
+        if not 1 <= port <= self.num_ports:
+            return
+        self.present[port] = not self.present[port]
+        self.generation[port] = (self.generation[port] + 1) & 0xff
+        if self.present[port]:
+            self.xcvrs[port] = Transceiver(port, self.args.type)
+        self.stats['hotplug'] += 1
+        if self.args.verbose:
+            print('mdipc_sim: port {} {}'.format(port, 'inserted' if self.present[port] else 'removed'))
+
+    def handle(self, mm):
+        port = _u32(mm, OFF_PORT)
+        op = _u32(mm, OFF_OP)
+        page = _u32(mm, OFF_PAGE)
+        offset = _u32(mm, OFF_OFFSET)
+        num_bytes = _u32(mm, OFF_NUM_BYTES)
+
+        if op == MDIPC_PRESENCE_BULK:
+            if self.args.no_bulk:
+                return MDIPC_RSP_FAIL
+            # request size is bitmap + one generation byte per port
+            num_ports = 0
+            while (num_ports + 1) + (num_ports + 8) // 8 <= num_bytes:
+                num_ports += 1
+            bitmap_len = (num_ports + 7) // 8
+            data = bytearray(num_bytes)
+            for p in range(1, min(num_ports, self.num_ports) + 1):
+                if self.present[p]:
+                    data[(p - 1) >> 3] |= 1 << ((p - 1) & 7)
+                data[bitmap_len + p - 1] = self.generation[p]
+            mm[OFF_DATA:OFF_DATA + num_bytes] = data
+            return MDIPC_RSP_SUCCESS
+
+        if not 1 <= port <= self.num_ports:
+            return MDIPC_RSP_FAIL
+        if op == MDIPC_PRESENCE:
+            # the NDK answers FAIL for a present module
+            return MDIPC_RSP_FAIL if self.present[port] else MDIPC_RSP_SUCCESS
+        if not self.present[port]:
+            return MDIPC_RSP_NOTPRESENT
+        if op == MDIPC_READ:
+            data = self.xcvrs[port].read(page, offset, num_bytes)
+            if data is None:
+                return MDIPC_RSP_FAIL
+            mm[OFF_DATA:OFF_DATA + num_bytes] = data
+            return MDIPC_RSP_SUCCESS
+        if op == MDIPC_WRITE:
+            if self.xcvrs[port].write(page, offset, bytes(mm[OFF_DATA:OFF_DATA + num_bytes])):
+                return MDIPC_RSP_SUCCESS
+            return MDIPC_RSP_FAIL
+        return MDIPC_RSP_FAIL
+
+    def respond(self, mm):
+        self.stats['msgs'] += 1
+        if (self.args.timeout_rate > 0) and (random.random() < self.args.timeout_rate):
+            # never answer; the client times out and frees the channel itself
+            _put_u32(mm, OFF_OWN, MDIPC_OWN_NOS_PREP)
+            self.stats['dropped'] += 1
+            return
+        if self.args.latency_us or self.args.jitter_us:
+            delay = self.args.latency_us + random.uniform(-self.args.jitter_us, self.args.jitter_us)
+            if delay > 0:
+                time.sleep(delay / 1000000.0)
+        status = self.handle(mm)
+        _put_u32(mm, OFF_STATUS, status)
+        _put_u32(mm, OFF_OWN, MDIPC_OWN_NOS_RSP)
+
+    def run(self):
+        poll = self.args.poll_us / 1000000.0
+        report = time.monotonic() + self.args.report_interval if self.args.report_interval else None
+        while self.running:
+            busy = False
+            for fd, mm in self.channels:
+                if _u32(mm, OFF_OWN) == MDIPC_OWN_NDK:
+                    self.respond(mm)
+                    busy = True
+            now = time.monotonic()
+            if (self.next_hotplug is not None) and (now >= self.next_hotplug):
+                self.hotplug()
+                self.next_hotplug = now + self.args.hotplug_interval
+            if (report is not None) and (now >= report):
+                print('mdipc_sim: msgs {msgs} dropped {dropped} hotplug {hotplug}'.format(**self.stats))
+                report = now + self.args.report_interval
+            if not busy:
+                time.sleep(poll)
+
+    def stop(self, signum, frame):
+        self.running = False
+
+
+def _port_list(text):
+    ports = []
+    for item in text.split(','):
+        if not item:
+            continue
+        if '-' in item:
+            first, last = item.split('-')
+            ports.extend(range(int(first), int(last) + 1))
+        else:
+            ports.append(int(item))
+    return ports
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MDIPC responder simulator')
+    parser.add_argument('--base', default='/tmp/mdipc/MDIPC', help='channel file base name (client NOKIA_MDIPC_BASE_NAME)')
+    parser.add_argument('--ports', type=int, default=36, help='number of ports on the simulated card')
+    parser.add_argument('--type', choices=['cmis', 'sff8636'], default='cmis', help='EEPROM image type')
+    parser.add_argument('--absent', type=_port_list, default=[], help='ports with no module, e.g. 3,5,10-12')
+    parser.add_argument('--latency-us', type=float, default=0, help='added response latency')
+    parser.add_argument('--jitter-us', type=float, default=0, help='uniform +/- jitter on the latency')
+    parser.add_argument('--timeout-rate', type=float, default=0, help='fraction of requests never answered')
+    parser.add_argument('--hotplug-interval', type=float, default=0, help='toggle a module every N seconds')
+    parser.add_argument('--hotplug-ports', type=_port_list, default=[], help='ports eligible for hot-plug')
+    parser.add_argument('--no-bulk', action='store_true', help='reject MDIPC_PRESENCE_BULK like an older NDK')
+    parser.add_argument('--poll-us', type=float, default=100, help='idle channel poll interval')
+    parser.add_argument('--report-interval', type=float, default=0, help='print counters every N seconds')
+    parser.add_argument('--verbose', action='store_true')
+    args = parser.parse_args()
+
+    responder = Responder(args)
+    responder.create_channels()
+    signal.signal(signal.SIGINT, responder.stop)
+    signal.signal(signal.SIGTERM, responder.stop)
+    try:
+        responder.run()
+    finally:
+        responder.remove_channels()
+        print('mdipc_sim: msgs {msgs} dropped {dropped} hotplug {hotplug}'.format(**responder.stats))
+
+
+if __name__ == '__main__':
+    main()
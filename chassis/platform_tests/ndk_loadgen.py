@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+#
+# Name: ndk_loadgen.py, version: 1.0
+#
+# Description: Load generator for the platform NDK gRPC client side of the
+# IXR7250 sonic_platform classes.  Replays the polling mix of the pmon
+# daemons through the Chassis/Psu/Fan/Thermal/Module APIs and reports RPC
+# rate, latency percentiles, channel setups and client CPU cost, e.g.
+#
+#   python3 ndk_mock_server.py --write-channel-file --latency-us 300 &
+#   python3 ndk_loadgen.py --mix pmon --speedup 10 --duration 60
+#
+# Mixes:
+#   thermalctld - thermal and fan sweeps
+#   psud        - PSU status sweeps
+#   chassisd    - module status sweeps
+#   pmon        - all of the above concurrently
+#
+# Polling periods are those of the daemons, divided by --speedup.  The
+# classes' own response caches are honoured unless --defeat-cache is given.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import os
+import threading
+import time
+
+import grpc
+from platform_ndk import nokia_common
+from platform_ndk import nokia_replay
+from sonic_platform.chassis import Chassis
+
+THERMALCTLD_PERIOD = 60
+PSUD_PERIOD = 3
+CHASSISD_PERIOD = 10
+
+THERMAL_CALLS = ('get_temperature', 'get_high_threshold', 'get_low_threshold',
+                 'get_high_critical_threshold', 'get_low_critical_threshold',
+                 'get_minimum_recorded', 'get_maximum_recorded')
+FAN_CALLS = ('get_presence', 'get_status', 'get_speed', 'get_target_speed',
+             'get_speed_tolerance', 'get_model', 'get_serial', 'get_status_led')
+PSU_CALLS = ('get_presence', 'get_status', 'get_voltage', 'get_current', 'get_power',
+             'get_temperature', 'get_temperature_high_threshold', 'get_voltage_high_threshold',
+             'get_voltage_low_threshold', 'get_maximum_supplied_power', 'get_model', 'get_serial')
+MODULE_CALLS = ('get_name', 'get_presence', 'get_oper_status', 'get_description',
+                'get_slot', 'get_midplane_ip')
+
+
+def percentile(samples, pct):
+    return samples[min(len(samples) - 1, int(len(samples) * pct / 100.0))]
+
+
+class RpcRecorder(grpc.UnaryUnaryClientInterceptor):
+    """
+    Per-method latency of every RPC issued through nokia_common
+    """
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.samples = {}
+        self.errors = {}
+        self.setups = []
+
+    def intercept_unary_unary(self, continuation, client_call_details, request):
+        method = client_call_details.method.rsplit('/', 1)[-1]
+        start = time.monotonic_ns()
+        outcome = continuation(client_call_details, request)
+        failed = outcome.exception() is not None
+        usecs = (time.monotonic_ns() - start) // 1000
+        with self.lock:
+            self.samples.setdefault(method, []).append(usecs)
+            if failed:
+                self.errors[method] = self.errors.get(method, 0) + 1
+        return outcome
+
+    def install(self):
+        insecure_channel = grpc.insecure_channel
+        channel_setup = nokia_common.channel_setup
+        midplane_channel_setup = nokia_common.midplane_channel_setup
+
+        def intercepted_channel(*args, **kwargs):
+            return grpc.intercept_channel(insecure_channel(*args, **kwargs), self)
+
+        def timed(func):
+            def setup(*args):
+                start = time.monotonic_ns()
+                ret = func(*args)
+                with self.lock:
+                    self.setups.append((time.monotonic_ns() - start) // 1000)
+                return ret
+            return setup
+
+        grpc.insecure_channel = intercepted_channel
+        nokia_common.channel_setup = timed(channel_setup)
+        nokia_common.midplane_channel_setup = timed(midplane_channel_setup)
+
+    def report(self, elapsed):
+        print('{:<28} {:>8} {:>9} {:>8} {:>8} {:>8} {:>8} {:>6}'.format(
+            'rpc', 'count', 'rate/s', 'p50(us)', 'p90(us)', 'p99(us)', 'max(us)', 'errors'))
+        total = 0
+        for method in sorted(self.samples):
+            lat = sorted(self.samples[method])
+            total += len(lat)
+            print('{:<28} {:>8} {:>9.1f} {:>8} {:>8} {:>8} {:>8} {:>6}'.format(
+                method, len(lat), len(lat) / elapsed, percentile(lat, 50), percentile(lat, 90),
+                percentile(lat, 99), lat[-1], self.errors.get(method, 0)))
+        print('total rpcs {} ({:.1f}/s)'.format(total, total / elapsed))
+        if self.setups:
+            setups = sorted(self.setups)
+            print('channel setups {} p50 {}us p99 {}us max {}us'.format(
+                len(setups), percentile(setups, 50), percentile(setups, 99), setups[-1]))
+
+
+class Poller():
+    """
+    One pmon daemon: sweeps a set of devices every period seconds
+    """
+
+    def __init__(self, name, period, devices, calls, defeat_cache):
+        self.name = name
+        self.period = period
+        self.devices = devices
+        self.calls = calls
+        self.defeat_cache = defeat_cache
+        self.sweeps = []
+
+    def sweep(self):
+        for device in self.devices:
+            if self.defeat_cache and hasattr(device, 'timestamp'):
+                device.timestamp = 0
+            for call in self.calls:
+                getattr(device, call)()
+
+    def run(self, deadline):
+        while time.monotonic() < deadline:
+            start = time.monotonic()
+            self.sweep()
+            self.sweeps.append(int((time.monotonic() - start) * 1000000))
+            time.sleep(max(0, self.period - (time.monotonic() - start)))
+
+
+def build_pollers(chassis, mix, speedup, defeat_cache):
+    pollers = []
+    if mix in ('thermalctld', 'pmon'):
+        fans = [fan for drawer in chassis.get_all_fan_drawers() for fan in drawer.get_all_fans()]
+        pollers.append(Poller('thermalctld-thermal', THERMALCTLD_PERIOD / speedup,
+                              chassis.get_all_thermals(), THERMAL_CALLS, defeat_cache))
+        pollers.append(Poller('thermalctld-fan', THERMALCTLD_PERIOD / speedup,
+                              fans, FAN_CALLS, defeat_cache))
+    if mix in ('psud', 'pmon'):
+        pollers.append(Poller('psud', PSUD_PERIOD / speedup,
+                              chassis.get_all_psus(), PSU_CALLS, defeat_cache))
+    if mix in ('chassisd', 'pmon'):
+        pollers.append(Poller('chassisd', CHASSISD_PERIOD / speedup,
+                              chassis.get_all_modules(), MODULE_CALLS, defeat_cache))
+    return pollers
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Platform NDK client load generator')
+    parser.add_argument('--mix', choices=['thermalctld', 'psud', 'chassisd', 'pmon'], default='pmon')
+    parser.add_argument('--duration', type=float, default=30, help='seconds')
+    parser.add_argument('--speedup', type=float, default=1.0, help='divide the daemon polling periods')
+    parser.add_argument('--defeat-cache', action='store_true', help='expire the client caches before each sweep')
+    args = parser.parse_args()
+
+    rec = RpcRecorder()
+    rec.install()
+
+    start = time.monotonic()
+    chassis = Chassis()
+    pollers = build_pollers(chassis, args.mix, args.speedup, args.defeat_cache)
+    print('device discovery {:.1f}ms, {} rpcs'.format(
+        (time.monotonic() - start) * 1000, sum(len(s) for s in rec.samples.values())))
+
+    with rec.lock:
+        rec.samples = {}
+        rec.errors = {}
+        rec.setups = []
+
+    deadline = time.monotonic() + args.duration
+    threads = [threading.Thread(target=poller.run, args=(deadline,)) for poller in pollers]
+    cpu_start = os.times()
+    start = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+    cpu_end = os.times()
+
+    cpu = (cpu_end.user - cpu_start.user) + (cpu_end.system - cpu_start.system)
+    print('mix {} speedup {} elapsed {:.1f}s client cpu {:.2f}s ({:.1f}%)'.format(
+        args.mix, args.speedup, elapsed, cpu, 100.0 * cpu / elapsed))
+    for poller in pollers:
+        if poller.sweeps:
+            sweeps = sorted(poller.sweeps)
+            print('sweep {:<20} devices {:>3} count {:>5} p50 {}us max {}us'.format(
+                poller.name, len(poller.devices), len(sweeps), percentile(sweeps, 50), sweeps[-1]))
+    rec.report(elapsed)
+
+    replay = nokia_replay.get_stats()
+    if replay:
+        print('replay speed {} answers {} not in capture {} ndk time {}s'.format(
+            replay['speed'], replay['served'], replay['missed'], replay['delay_secs']))
+
+
+if __name__ == '__main__':
+    main()
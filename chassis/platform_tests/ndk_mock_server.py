@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+#
+# Name: ndk_mock_server.py, version: 1.0
+#
+# Description: Mock of the platform NDK (devmgr) gRPC server for running
+# the IXR7250 sonic_platform classes and nokia_cmd off the chassis.
+#
+# Every service and method in platform_ndk_pb2 is served.  Responses are
+# built from a scenario, a JSON object keyed by method name (or
+# 'Service/Method' where the name is ambiguous):
+#
+#   {
+#     "latency_us": 200,
+#     "methods": {
+#       "GetMySlot": {"response": {"my_slot": 0}},
+#       "GetPsuStatusInfo": {
+#         "match": "psu_idx",
+#         "cases": {"3": {"status_info": {"psu_presence": false}}},
+#         "response": {"status_info": {"psu_presence": true, ...}},
+#         "latency_us": 1500, "jitter_us": 500,
+#         "error_rate": 0.01, "grpc_error": "UNAVAILABLE"
+#       }
+#     }
+#   }
+#
+# 'match' names a request field (dotted for nested messages, e.g.
+# 'idx.fantray_idx'); a matching 'cases' entry is merged over 'response'.
+# Methods not in the scenario return an empty response with NDK_SUCCESS.
+# The scenario file given with --scenario is merged over the built-in
+# default and is re-read on SIGHUP so state can be changed while clients
+# are running, e.g.
+#
+#   python3 ndk_mock_server.py --write-channel-file --latency-us 300 &
+#   nokia_cmd show psu
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import copy
+import json
+import os
+import random
+import signal
+import sys
+import threading
+import time
+from concurrent import futures
+
+import grpc
+from google.protobuf import json_format
+from platform_ndk import nokia_common
+from platform_ndk import platform_ndk_pb2
+
+DEFAULT_ADDRESS = 'unix:///tmp/nokia_mock_ndk.sock'
+
+NUM_PSUS = 6
+NUM_FANTRAYS = 3
+NUM_LINECARDS = 8
+NUM_FABRICS = 6
+NUM_SFPS = 36
+THERMAL_SENSORS = ['Ambient', 'CPU', 'Board', 'Inlet', 'Outlet']
+
+
+def _default_scenario():
+    """
+    IXR-10 supervisor with all PSUs, fan trays and line cards online
+    """
+    methods = {}
+
+    methods['GetMySlot'] = {'response': {'my_slot': nokia_common.NOKIA_CPM_SLOT_NUMBER}}
+    methods['GetChassisType'] = {'response': {'chassis_type': 'HW_CHASSIS_TYPE_IXR10'}}
+    methods['GetChassisProperties'] = {'response': {'chassis_property': {'hw_property': [
+        {'module_type': 'HW_MODULE_TYPE_CONTROL', 'max_num': 1},
+        {'module_type': 'HW_MODULE_TYPE_LINE', 'max_num': NUM_LINECARDS},
+        {'module_type': 'HW_MODULE_TYPE_FABRIC', 'max_num': NUM_FABRICS}]}}}
+    methods['GetModuleBulkInfo'] = {'response': {'module_info': {
+        'status': 'HW_MODULE_STATUS_ONLINE',
+        'name': 'imm36-400g-qsfpdd',
+        'chassis_type': 'HW_CHASSIS_TYPE_IXR10'}}}
+    methods['GetModuleMaxPower'] = {'response': {}}
+
+    methods['GetPsuNum'] = {'response': {'num_psus': NUM_PSUS}}
+    psu = {'psu_presence': True, 'psu_status': True,
+           'output_current': 25.5, 'output_voltage': 54.0, 'output_power': 1377.0,
+           'input_current': 6.2, 'input_voltage': 240.0, 'input_power': 1488.0,
+           'ambient_temp': 31.0, 'min_voltage': 48.0, 'max_voltage': 60.0,
+           'max_temperature': 70.0, 'supplied_power': 3000.0}
+    methods['GetPsuStatusInfo'] = {'response': {'status_info': psu}}
+    fru = {'product_name': 'PSU-AC-3000', 'part_number': '3HE12345AA', 'serial_number': 'NS0000000001'}
+    methods['GetPsuModel'] = {'response': {'fru_info': fru}}
+    methods['GetPsuSerial'] = {'response': {'fru_info': fru}}
+
+    methods['GetFanNum'] = {'response': {'fan_nums': {'num_fantrays': NUM_FANTRAYS}}}
+    methods['GetFanTrayInfo'] = {'response': {'fan_info': {
+        'partno': '3HE16500AA', 'serialno': 'NS0000000100', 'presence': True, 'status': 'Online'}}}
+    methods['GetFanActualSpeed'] = {'response': {'fan_speed_actual': {'fantray_speed': 40}}}
+    methods['GetFanTargetSpeed'] = {'response': {'fan_speed_target': {'fantray_speed': 40}}}
+    methods['GetFanTolerance'] = {'response': {'fan_tolerance': 25}}
+
+    methods['GetThermalDevicesInfo'] = {'response': {'temp_devices': {'temp_device': [
+        {'device_idx': i, 'sensor_name': name, 'fanalgo_sensor': True}
+        for i, name in enumerate(THERMAL_SENSORS)]}}}
+    methods['GetThermalAllTempInfo'] = {'response': {'temp_info': {
+        'curr_temp': 38.0, 'min_temp': 30.0, 'max_temp': 45.0,
+        'low_threshold': 0.0, 'high_threshold': 85.0}}}
+
+    methods['GetSfpNumAndType'] = {'response': {'sfp_num_type': {
+        'num_ports': NUM_SFPS, 'type1_hw_port_id_end': NUM_SFPS,
+        'type1_port': 'SFP_MODULE_TYPE_QSFPDD'}}}
+
+    methods['GetLed'] = {'response': {'led_get': {'led_info': [
+        {'led_color': 'LED_COLOR_GREEN', 'led_state': 'LED_STATE_ON'}]}}}
+
+    return {'latency_us': 0, 'jitter_us': 0, 'methods': methods}
+
+
+def _merge(base, overlay):
+    for key, val in overlay.items():
+        if isinstance(val, dict) and isinstance(base.get(key), dict):
+            _merge(base[key], val)
+        else:
+            base[key] = copy.deepcopy(val)
+    return base
+
+
+def _request_field(request, path):
+    val = request
+    for name in path.split('.'):
+        val = getattr(val, name, None)
+        if val is None:
+            return None
+    return val
+
+
+class MockNdk():
+    def __init__(self, scenario_file, latency_us, jitter_us):
+        self.scenario_file = scenario_file
+        self.lock = threading.Lock()
+        self.counts = {}
+        self.errors = {}
+        self.override = {'latency_us': latency_us, 'jitter_us': jitter_us}
+        self.load()
+
+    def load(self):
+        scenario = _default_scenario()
+        if self.scenario_file:
+            with open(self.scenario_file, 'r') as f:
+                _merge(scenario, json.load(f))
+        for key, val in self.override.items():
+            if val is not None:
+                scenario[key] = val
+        self.scenario = scenario
+
+    def _entry(self, service, method):
+        methods = self.scenario['methods']
+        return methods.get(service + '/' + method, methods.get(method, {}))
+
+    def _response(self, entry, request, response_class):
+        body = copy.deepcopy(entry.get('response', {}))
+        match = entry.get('match')
+        if match:
+            case = entry.get('cases', {}).get(str(_request_field(request, match)))
+            if case:
+                _merge(body, case)
+        response = response_class()
+        json_format.ParseDict(body, response, ignore_unknown_fields=True)
+        return response
+
+    def handler(self, service, method, response_class):
+        def serve(request, context):
+            entry = self._entry(service, method)
+            with self.lock:
+                self.counts[method] = self.counts.get(method, 0) + 1
+
+            latency = entry.get('latency_us', self.scenario.get('latency_us', 0))
+            jitter = entry.get('jitter_us', self.scenario.get('jitter_us', 0))
+            if latency or jitter:
+                time.sleep(max(0, latency + random.uniform(-jitter, jitter)) / 1000000.0)
+
+            if random.random() < entry.get('error_rate', 0):
+                with self.lock:
+                    self.errors[method] = self.errors.get(method, 0) + 1
+                code = getattr(grpc.StatusCode, entry.get('grpc_error', 'UNAVAILABLE'))
+                context.abort(code, 'mock NDK injected error')
+
+            return self._response(entry, request, response_class)
+        return serve
+
+    def report(self):
+        with self.lock:
+            counts = dict(self.counts)
+            errors = dict(self.errors)
+        total = sum(counts.values())
+        print('{:<32} {:>10} {:>8}'.format('method', 'rpcs', 'errors'))
+        for method in sorted(counts, key=counts.get, reverse=True):
+            print('{:<32} {:>10} {:>8}'.format(method, counts[method], errors.get(method, 0)))
+        print('{:<32} {:>10} {:>8}'.format('total', total, sum(errors.values())))
+        sys.stdout.flush()
+
+
+def build_server(ndk, address, workers):
+    server = grpc.server(futures.ThreadPoolExecutor(max_workers=workers))
+    handlers = []
+    for service in platform_ndk_pb2.DESCRIPTOR.services_by_name.values():
+        method_handlers = {}
+        for method in service.methods:
+            request_class = getattr(platform_ndk_pb2, method.input_type.name)
+            response_class = getattr(platform_ndk_pb2, method.output_type.name)
+            method_handlers[method.name] = grpc.unary_unary_rpc_method_handler(
+                ndk.handler(service.name, method.name, response_class),
+                request_deserializer=request_class.FromString,
+                response_serializer=response_class.SerializeToString)
+        handlers.append(grpc.method_handlers_generic_handler(service.full_name, method_handlers))
+    server.add_generic_rpc_handlers(handlers)
+    server.add_insecure_port(address)
+    return server
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Mock platform NDK gRPC server')
+    parser.add_argument('--address', default=DEFAULT_ADDRESS,
+                        help='listen address, unix:///path or host:port')
+    parser.add_argument('--scenario', help='JSON scenario merged over the built-in default')
+    parser.add_argument('--latency-us', type=int, help='latency of every RPC')
+    parser.add_argument('--jitter-us', type=int, help='+/- uniform jitter of every RPC')
+    parser.add_argument('--workers', type=int, default=16, help='server threads')
+    parser.add_argument('--write-channel-file', action='store_true',
+                        help='point clients at this server through ' + nokia_common.NOKIA_CHANNEL_FILE_PATH)
+    parser.add_argument('--report-interval', type=float, default=0, help='seconds, 0 reports at exit only')
+    parser.add_argument('--dump-scenario', action='store_true', help='print the effective scenario and exit')
+    args = parser.parse_args()
+
+    ndk = MockNdk(args.scenario, args.latency_us, args.jitter_us)
+    if args.dump_scenario:
+        print(json.dumps(ndk.scenario, indent=2))
+        return
+
+    if args.address.startswith(nokia_common.NOKIA_UNIX_SOCKET_PREFIX):
+        path = args.address[len(nokia_common.NOKIA_UNIX_SOCKET_PREFIX):]
+        if os.path.exists(path):
+            os.unlink(path)
+
+    server = build_server(ndk, args.address, args.workers)
+    server.start()
+    if args.write_channel_file:
+        with open(nokia_common.NOKIA_CHANNEL_FILE_PATH, 'w') as f:
+            f.write(args.address + '\n')
+    print('mock NDK serving {} services on {}'.format(
+        len(platform_ndk_pb2.DESCRIPTOR.services_by_name), args.address))
+    sys.stdout.flush()
+
+    stop = threading.Event()
+
+    def reload(signum, frame):
+        try:
+            ndk.load()
+            print('scenario reloaded')
+        except (OSError, ValueError) as e:
+            print('scenario reload failed: {}'.format(e))
+
+    signal.signal(signal.SIGHUP, reload)
+    signal.signal(signal.SIGTERM, lambda signum, frame: stop.set())
+    signal.signal(signal.SIGINT, lambda signum, frame: stop.set())
+
+    while not stop.wait(args.report_interval or None):
+        ndk.report()
+
+    server.stop(0)
+    if args.write_channel_file:
+        try:
+            os.unlink(nokia_common.NOKIA_CHANNEL_FILE_PATH)
+        except OSError:
+            pass
+    ndk.report()
+
+
+if __name__ == '__main__':
+    main()
@@ -44,3 +44,37 @@ def test_chassis_info():
     slot = chassis.get_my_slot()
     print("my slot: {}".format(slot))
     assert slot != ''
+
+
+def test_sfp_presence_snapshot():
+    chassis = Chassis()
+    presence, generation = chassis.get_sfp_presence_snapshot()
+    if chassis.is_slot_cpm():
+        assert presence == {}
+        return
+    assert len(presence) == chassis.get_num_sfps()
+    for xcvr in chassis.get_all_sfps():
+        assert presence[xcvr.index] == xcvr.get_presence()
+        assert generation[xcvr.index] >= 0
+
+
+def test_watchdog_kick_stats():
+    chassis = Chassis()
+    watchdog = chassis.get_watchdog()
+    stats = watchdog.get_kick_stats()
+    print("watchdog kick stats: {}".format(stats))
+    if not stats['running']:
+        assert watchdog.is_armed() is False
+        return
+    assert stats['kicks'] > 0
+    assert stats['last_kick_age'] <= 2 * stats['period']
+    # arm far out and disarm, never left armed even if an assert fails
+    try:
+        assert watchdog.arm(3600) == 3600
+        assert watchdog.is_armed() is True
+        assert 0 < watchdog.get_remaining_time() <= 3600
+    finally:
+        disarmed = watchdog.disarm()
+    assert disarmed is True
+    assert watchdog.is_armed() is False
+    assert watchdog.get_remaining_time() == -1
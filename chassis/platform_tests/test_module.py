@@ -111,3 +111,28 @@ def test_module_sanity():
         assert module.is_replaceable() is True
         assert module.get_position_in_parent() != -1
         assert module.set_admin_state(True) is False
+
+
+def test_module_bulk_info_latency():
+    modules = chassis.get_all_modules()
+    latency = chassis.get_module_bulk_info_latency()
+    assert len(latency) == len(modules)
+    for module in modules:
+        stats = latency[module.get_name()]
+        print('Module {} slot {} bulk info last {}us max {}us failures {}'.format(
+            module.get_name(), stats['slot'], stats['last_usecs'], stats['max_usecs'], stats['failures']))
+        assert stats['max_usecs'] >= stats['last_usecs']
+
+    # a forced refresh records a latency or a failure for every module it fetched
+    for module in modules:
+        module.timestamp = 0
+        module.bulk_info_retry_time = 0
+    before = chassis.get_module_bulk_info_latency()
+    refreshed = chassis.refresh_module_bulk_info()
+    after = chassis.get_module_bulk_info_latency()
+    for name, usecs in refreshed.items():
+        if usecs is None:
+            assert after[name]['failures'] == before[name]['failures'] + 1
+        else:
+            assert after[name]['last_usecs'] == usecs
+            assert after[name]['failures'] == before[name]['failures']
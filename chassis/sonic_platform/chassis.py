@@ -22,9 +22,12 @@ try:
     from sonic_py_common.logger import Logger
     from swsscommon import swsscommon
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_inventory
     from platform_ndk import platform_ndk_pb2
     import os
     import threading
+    import time
+    from concurrent import futures
 
 except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
@@ -34,6 +37,8 @@ NOKIA_MODULE_EEPROM_INFO_TABLE = 'NOKIA_MODULE_EEPROM_INFO_TABLE'
 NOKIA_LINECARD_INFO_KEY_TEMPLATE = 'LINE-CARD'
 NOKIA_SUPERVISOR_INFO_KEY_TEMPLATE = 'SUPERVISOR'
 NOKIA_MODULE_EEPROM_INFO_FIELD = 'eeprom_info'
+# GetModuleBulkInfo deadline of a single module during the supervisor fan-out
+NOKIA_MODULE_BULK_INFO_DEADLINE_SECS = 2.0
 
 class Chassis(ChassisBase):
     """
@@ -52,6 +57,7 @@ class Chassis(ChassisBase):
     def __init__(self):
         ChassisBase.__init__(self)
         # logger.set_min_log_priority_info()
+        nokia_common.rpc_recorder_register()
 
         # Chassis specific slot numbering
         self._cached_is_chassis_modular = False
@@ -70,6 +76,8 @@ class Chassis(ChassisBase):
         # self._get_module_list()
         self._module_list = []
         self.module_module_initialized = False
+        self.module_refresh_lock = threading.Lock()
+        self.module_refresh_executor = None
 
         # PSU list
         # self._get_psu_list()
@@ -189,7 +197,7 @@ class Chassis(ChassisBase):
 
     def is_modular_chassis(self):
         if self._cached_is_chassis_modular == False:
-            self.is_chassis_modular = nokia_common.is_chassis_modular()
+            self.is_chassis_modular = nokia_common.is_chassis_type_modular(nokia_inventory.chassis_type())
             self._cached_is_chassis_modular = True
 
         return self.is_chassis_modular
@@ -204,7 +212,11 @@ class Chassis(ChassisBase):
 
     def _get_module_sfm_eeprom(self, sfm_num):
         if self.sfm_eeprom_initialized == False:
-            self._sfm_eeprom_list = nokia_common._get_sfm_eeprom_info_list()
+            # SFMs are hot-swappable, never from the inventory cache
+            sfm_eeprom_list = nokia_common._get_sfm_eeprom_info_list()
+            if sfm_eeprom_list is None:
+                return None
+            self._sfm_eeprom_list = sfm_eeprom_list
             self.sfm_eeprom_initialized = True
         i = 0
         while i < len(self._sfm_eeprom_list):
@@ -222,7 +234,7 @@ class Chassis(ChassisBase):
     def _get_my_hw_slot(self):
         # internal slot
         if self._cached_my_instance == False:
-            self.my_instance = nokia_common._get_my_slot()
+            self.my_instance = nokia_inventory.my_slot()
             self._cached_my_instance = True
 
         return self.my_instance
@@ -234,7 +246,7 @@ class Chassis(ChassisBase):
 
     def is_slot_cpm(self):
         if self._cached_is_cpm == False:
-            self.is_cpm = nokia_common.is_cpm()
+            self.is_cpm = (self._get_my_hw_slot() == nokia_common.NOKIA_CPM_SLOT_NUMBER)
             self._cached_is_cpm = True
 
         return self.is_cpm
@@ -268,12 +280,8 @@ class Chassis(ChassisBase):
             return self._module_list
 
         # Only on CPM
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE)
-        if not channel or not stub:
-            return []
-        ret, response = nokia_common.try_grpc(stub.GetChassisProperties,
-                                              platform_ndk_pb2.ReqModuleInfoPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE, 'GetChassisProperties',
+                                                       platform_ndk_pb2.ReqModuleInfoPb())
 
         if ret is False:
             return []
@@ -331,12 +339,8 @@ class Chassis(ChassisBase):
 
         # For CPM on chassis
         module_index = -1
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE)
-        if not channel or not stub:
-            return module_index
-        ret, response = nokia_common.try_grpc(stub.GetChassisProperties,
-                                              platform_ndk_pb2.ReqModuleInfoPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE, 'GetChassisProperties',
+                                                       platform_ndk_pb2.ReqModuleInfoPb())
 
         if ret is False:
             return module_index
@@ -384,12 +388,113 @@ class Chassis(ChassisBase):
         Returns:
             A list of objects representing all modules available on this chassis
         """
-        return (self._get_module_list())
+        self._get_module_list()
+        self._refresh_stale_module_bulk_info()
+        return self._module_list
 
     def get_module(self, index):
         self._get_module_list()
+        self._refresh_stale_module_bulk_info()
         return super(Chassis, self).get_module(index)
 
+    def _refresh_stale_module_bulk_info(self):
+        # chassisd walks every module in turn, refresh them all together on
+        # the first stale one so each module getter then hits its cache
+        if not self.is_slot_cpm():
+            return
+        current_time = time.time()
+        for module in self._module_list:
+            if module._module_bulk_info_is_due(current_time):
+                self.refresh_module_bulk_info()
+                return
+
+    def refresh_module_bulk_info(self, deadline=NOKIA_MODULE_BULK_INFO_DEADLINE_SECS):
+        """
+        Fetches the bulk info of all stale modules concurrently, each bounded
+        by deadline seconds, then applies the results to the modules. A
+        module that fails or misses the deadline stays stale and keeps its
+        previous state; it is retried after a backoff rather than by every
+        getter.
+        Returns:
+            A dict keyed by module name of the GetModuleBulkInfo latency in
+            usecs, None for a module that failed or missed the deadline
+        """
+        with self.module_refresh_lock:
+            current_time = time.time()
+            stale = [module for module in self._module_list
+                     if module._module_bulk_info_is_due(current_time)]
+            if not stale:
+                return {}
+
+            # one worker per module plus the SFM eeprom fetch
+            if self.module_refresh_executor is None:
+                self.module_refresh_executor = futures.ThreadPoolExecutor(
+                    max_workers=len(self._module_list) + 1, thread_name_prefix='module-bulk-info')
+
+            pending = {self.module_refresh_executor.submit(module._fetch_module_bulk_info, deadline): module
+                       for module in stale}
+            # the SFM eeprom list once for all fabric modules, in the same deadline
+            sfm_eeprom_future = None
+            if any(module.get_type() == ModuleBase.MODULE_TYPE_FABRIC for module in stale):
+                sfm_eeprom_future = self.module_refresh_executor.submit(
+                    nokia_common._get_sfm_eeprom_info_list, deadline)
+            # channel_setup() waits up to 0.5 seconds for the channel on top of the RPC deadline
+            done, not_done = futures.wait(list(pending) + ([sfm_eeprom_future] if sfm_eeprom_future else []),
+                                          timeout=deadline + 0.5)
+            sfm_eeprom_list = None
+            if sfm_eeprom_future in done:
+                try:
+                    sfm_eeprom_list = sfm_eeprom_future.result()
+                except Exception as e:
+                    logger.log_warning("SFM eeprom fetch failed: {}".format(e))
+            if sfm_eeprom_list is None:
+                # the fabric modules keep their previous eeprom
+                sfm_eeprom_list = []
+
+            latency = {}
+            for future, module in pending.items():
+                if future in done:
+                    try:
+                        response, usecs = future.result()
+                    except Exception as e:
+                        logger.log_warning("{} GetModuleBulkInfo raised {}".format(module.get_name(), e))
+                        response, usecs = None, int((time.time() - current_time) * 1000000)
+                else:
+                    response, usecs = None, int((time.time() - current_time) * 1000000)
+                if response is None:
+                    module._record_module_bulk_info_latency(usecs, False)
+                    logger.log_warning("{} slot {} GetModuleBulkInfo failed after {}us".format(
+                        module.get_name(), module.get_slot(), usecs))
+                    latency[module.get_name()] = None
+                    continue
+                try:
+                    module._apply_module_bulk_info(response, current_time, sfm_eeprom_list)
+                except Exception as e:
+                    # one module must not keep the others stale, this one backs off
+                    module._record_module_bulk_info_latency(usecs, False)
+                    logger.log_warning("{} bulk info not applied: {}".format(module.get_name(), e))
+                    latency[module.get_name()] = None
+                    continue
+                module._record_module_bulk_info_latency(usecs, True)
+                latency[module.get_name()] = usecs
+
+            return latency
+
+    def get_module_bulk_info_latency(self):
+        """
+        Retrieves the GetModuleBulkInfo latency of each module
+        Returns:
+            A dict keyed by module name of dicts with the slot, last and max
+            latency in usecs and the number of failed fetches
+        """
+        stats = {}
+        for module in self._get_module_list():
+            stats[module.get_name()] = {'slot': module.get_slot(),
+                                        'last_usecs': module.bulk_info_last_usecs,
+                                        'max_usecs': module.bulk_info_max_usecs,
+                                        'failures': module.bulk_info_failures}
+        return stats
+
     # PSU and power related
     def _get_psu_list(self):
         if not self.is_slot_cpm():
@@ -398,12 +503,8 @@ class Chassis(ChassisBase):
         if self.psu_module_initialized:
             return self._psu_list
 
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_PSU_SERVICE)
-        if not channel or not stub:
-            return []
-        ret, response = nokia_common.try_grpc(stub.GetPsuNum,
-                                              platform_ndk_pb2.ReqPsuInfoPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_PSU_SERVICE, 'GetPsuNum',
+                                                       platform_ndk_pb2.ReqPsuInfoPb())
 
         if ret is False:
             return []
@@ -417,12 +518,8 @@ class Chassis(ChassisBase):
         return self._psu_list
 
     def _get_modules_consumed_power(self):
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE)
-        if not channel or not stub:
-            return
-        ret, response = nokia_common.try_grpc(stub.GetModuleMaxPower,
-                                              platform_ndk_pb2.ReqModuleInfoPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE, 'GetModuleMaxPower',
+                                                       platform_ndk_pb2.ReqModuleInfoPb())
 
         if ret is False:
             return
@@ -468,12 +565,8 @@ class Chassis(ChassisBase):
         # Get maximum power consumed by each module like cards, fan-trays etc
         self._get_modules_consumed_power()
 
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_FAN_SERVICE)
-        if not channel or not stub:
-            return []
-        ret, response = nokia_common.try_grpc(stub.GetFanNum,
-                                              platform_ndk_pb2.ReqFanTrayOpsPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_FAN_SERVICE, 'GetFanNum',
+                                                       platform_ndk_pb2.ReqFanTrayOpsPb())
 
         if ret is False:
             return []
@@ -492,6 +585,62 @@ class Chassis(ChassisBase):
         self.fan_drawer_module_initialized = True
         return self._fan_drawer_list
 
+    def _fan_trays_batch(self, rpc, build_request):
+        """
+        Applies one fan service RPC to every present fan tray in one
+        operation, see nokia_common.try_grpc_batch. Presence comes from the
+        fans' cache, expired entries are refreshed in one batch on the same
+        channel.
+        Returns:
+            A dict of fan tray index to True if the tray accepted it
+        """
+        fans = [fan for drawer in self._get_fantray_list() for fan in drawer.get_all_fans()]
+        if not fans:
+            return {}
+
+        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_FAN_SERVICE)
+        if not channel or not stub:
+            return {fan.fantray_idx: False for fan in fans if fan.presence}
+
+        stale = [fan for fan in fans if fan._fan_info_is_due()]
+        if stale:
+            now = time.time()
+            requests = [platform_ndk_pb2.ReqFanTrayOpsPb(
+                idx=platform_ndk_pb2.ReqFanTrayIndexPb(fantray_idx=fan.fantray_idx)) for fan in stale]
+            for fan, (ret, response) in zip(stale, nokia_common.try_grpc_batch(stub.GetFanTrayInfo, requests)):
+                fan._set_fan_info(ret, response, now)
+
+        trays = [fan.fantray_idx for fan in fans if fan.presence]
+        if not trays:
+            nokia_common.channel_shutdown(channel)
+            return {}
+        requests = [build_request(platform_ndk_pb2.ReqFanTrayIndexPb(fantray_idx=tray)) for tray in trays]
+        results = nokia_common.try_grpc_batch(getattr(stub, rpc), requests)
+        nokia_common.channel_shutdown(channel)
+        return {tray: ret for tray, (ret, response) in zip(trays, results)}
+
+    def set_all_fan_trays_speed(self, speed):
+        """
+        Sets the target speed of every fan tray in one operation
+        Args:
+            speed: An integer, the percentage of full fan speed, 0 to 100
+        Returns:
+            A dict of fan tray index to True if set
+        """
+        return self._fan_trays_batch('SetFanTargetSpeed', lambda req_idx:
+                                     platform_ndk_pb2.ReqFanTrayOpsPb(idx=req_idx, fantray_speed=speed))
+
+    def disable_all_fan_trays_algorithm(self, disable):
+        """
+        Disables or enables the fan algorithm of every fan tray in one
+        operation
+        Returns:
+            A dict of fan tray index to True if set
+        """
+        req_fan_algo = platform_ndk_pb2.SetFanTrayAlgorithmPb(fantray_algo_disable=disable)
+        return self._fan_trays_batch('DisableFanAlgorithm', lambda req_idx:
+                                     platform_ndk_pb2.ReqFanTrayOpsPb(idx=req_idx, fan_algo=req_fan_algo))
+
     def allow_fan_platform_override(self):
         from os import path
         if path.exists(nokia_common.NOKIA_ALLOW_FAN_OVERRIDE_FILE):
@@ -516,12 +665,11 @@ class Chassis(ChassisBase):
 
     # Thermal related
     def _get_thermal_list(self):
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_THERMAL_SERVICE)
-        if not channel or not stub:
-            return []
-        ret, response = nokia_common.try_grpc(stub.GetThermalDevicesInfo,
-                                              platform_ndk_pb2.ReqTempParamsPb())
-        nokia_common.channel_shutdown(channel)
+        # only the first list comes from the warm-start cache, later calls
+        # track sensors added at runtime
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_THERMAL_SERVICE, 'GetThermalDevicesInfo',
+                                                       platform_ndk_pb2.ReqTempParamsPb(),
+                                                       refresh=bool(self._thermal_list))
 
         if ret is False:
             return []
@@ -579,12 +727,8 @@ class Chassis(ChassisBase):
         if self.component_module_initialized:
             return self._component_list
 
-        channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_FIRMWARE_SERVICE)
-        if not channel or not stub:
-            return []
-        ret, response = nokia_common.try_grpc(stub.HwFirmwareGetComponents,
-                                              platform_ndk_pb2.ReqHwFirmwareInfoPb())
-        nokia_common.channel_shutdown(channel)
+        ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_FIRMWARE_SERVICE, 'HwFirmwareGetComponents',
+                                                       platform_ndk_pb2.ReqHwFirmwareInfoPb())
 
         if ret is False:
             return []
@@ -618,7 +762,7 @@ class Chassis(ChassisBase):
     def initialize_sfp(self):
         from sonic_platform.sfp import Sfp
 
-        if not nokia_common.is_cpm():
+        if not self.is_slot_cpm():
             # prevent Xcvrd threads from simultaneous access
             self.Tmutex.acquire()
             if self.sfp_module_initialized:
@@ -627,15 +771,8 @@ class Chassis(ChassisBase):
                 return
 
             op_type = platform_ndk_pb2.ReqSfpOpsType.SFP_OPS_NORMAL
-            channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_XCVR_SERVICE)
-            if not channel or not stub:
-                logger.log_error("Failure retrieving channel, stub in initialize_sfp")
-                self.Tmutex.release()
-                return False
-
-            ret, response = nokia_common.try_grpc(stub.GetSfpNumAndType,
-                                                  platform_ndk_pb2.ReqSfpOpsPb(type=op_type))
-            nokia_common.channel_shutdown(channel)
+            ret, response = nokia_inventory.inventory_grpc(nokia_common.NOKIA_GRPC_XCVR_SERVICE, 'GetSfpNumAndType',
+                                                           platform_ndk_pb2.ReqSfpOpsPb(type=op_type))
             if ret is False:
                 logger.log_error("Failure on GetSfpNumAndType in initialize_sfp")
                 self.Tmutex.release()
@@ -648,6 +785,9 @@ class Chassis(ChassisBase):
             # index 0 is placeholder with no valid entry
             # self._sfp_list.append(None)
 
+            # size the shared presence tables for this card's ports
+            Sfp.alloc_port_tables(self.num_sfp)
+
             self.sfp_stub = None
             for index in range(1, self.num_sfp+1):
                 if index <= msg.type1_hw_port_id_end:
@@ -704,7 +844,7 @@ class Chassis(ChassisBase):
         Returns:
             An integer, the number of sfps available on this chassis
         """
-        if nokia_common.is_cpm():
+        if self.is_slot_cpm():
             return 0
 
         if not self.sfp_module_initialized:
@@ -753,6 +893,36 @@ class Chassis(ChassisBase):
 
         return sfp
 
+    def get_sfp_presence_snapshot(self):
+        """
+        Retrieves the presence of all sfps on this card with a single
+        MDIPC exchange
+        Returns:
+            A tuple of two dicts keyed by 1-based sfp index: the presence
+            (bool) and the presence change generation (int) of each sfp.
+            The generation increments on every presence transition, so a
+            quick remove/insert between two snapshots is still visible.
+        """
+        from sonic_platform.sfp import Sfp
+
+        if self.is_slot_cpm():
+            return {}, {}
+
+        if not self.sfp_module_initialized:
+            self.initialize_sfp()
+
+        if Sfp.max_ports == 0:
+            return {}, {}
+
+        Sfp.refresh_presence_snapshot()
+        presence = {}
+        generation = {}
+        for index in range(1, Sfp.max_ports+1):
+            presence[index] = bool(Sfp.presence[index])
+            generation[index] = Sfp.presence_gen[index]
+
+        return presence, generation
+
     # System eeprom below
     def get_name(self):
         """
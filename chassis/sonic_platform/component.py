@@ -8,6 +8,10 @@
 #
 #
 try:
+    import os
+    import threading
+    import time
+    from concurrent import futures
     from sonic_platform_base.component_base import ComponentBase
     from platform_ndk import nokia_common
     from platform_ndk import platform_ndk_pb2
@@ -15,6 +19,50 @@ except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
 
 NOKIA_MAX_SFM_NO = 8
+# SFM FPGA images installed at once, operators opt in to more than one
+# with NOKIA_SFM_FW_CONCURRENCY
+NOKIA_SFM_FW_CONCURRENCY = 1
+# "<secs>[:<failing sfm>,...]" installs against a local stand-in instead of
+# the NDK, to time the orchestration offline
+NOKIA_SFM_FW_DRY_RUN = os.environ.get('NOKIA_SFM_FW_DRY_RUN')
+
+
+def sfm_fw_concurrency():
+    """
+    Returns NOKIA_SFM_FW_CONCURRENCY from the environment, the default if
+    it is unset or not a number
+    """
+    value = os.environ.get('NOKIA_SFM_FW_CONCURRENCY')
+    if value is None:
+        return NOKIA_SFM_FW_CONCURRENCY
+    try:
+        return int(value)
+    except ValueError:
+        print('Ignoring NOKIA_SFM_FW_CONCURRENCY={!r}, installing {} at a time'.format(
+            value, NOKIA_SFM_FW_CONCURRENCY))
+        return NOKIA_SFM_FW_CONCURRENCY
+
+
+class SfmFirmwareDryRunStub(object):
+    """
+    Stand-in for the firmware service stub: every HwFirmwareUpdate takes
+    secs and fails for the SFMs in fail_sfms
+    """
+
+    def __init__(self, spec):
+        secs, _, fail = spec.partition(':')
+        self.secs = float(secs or 0)
+        self.fail_sfms = set(int(sfm) for sfm in fail.split(',') if sfm)
+
+    def HwFirmwareUpdate(self, request):
+        time.sleep(self.secs)
+        if request.sfm_no in self.fail_sfms:
+            resp_status = platform_ndk_pb2.ResponseStatus(status_code=platform_ndk_pb2.ResponseCode.NDK_ERR_FAILURE,
+                                                          error_msg='dry-run failure')
+        else:
+            resp_status = platform_ndk_pb2.ResponseStatus(status_code=platform_ndk_pb2.ResponseCode.NDK_SUCCESS)
+        return platform_ndk_pb2.DefaultResponse(response_status=resp_status)
+
 
 class Component(ComponentBase):
     """Nokia Platform-specific Component class"""
@@ -145,6 +193,60 @@ class Component(ComponentBase):
 
         return "Please reboot after FW install"
 
+    def _sfm_progress(self, sfm_num, phase, start, detail=''):
+        with self._progress_lock:
+            print('[{:7.1f}s] SFM{} {}{}'.format(time.monotonic() - start, sfm_num, phase,
+                                                 ' ' + detail if detail else ''), flush=True)
+
+    def _install_sfm_firmware(self, stub, sfm_num, image_path, start):
+        self._sfm_progress(sfm_num, 'installing', start)
+        sfm_start = time.monotonic()
+        ret, response = nokia_common.try_grpc(stub.HwFirmwareUpdate,
+                                              platform_ndk_pb2.ReqHwFirmwareInfoPb(dev_type=self.dev_type, sfm_no=sfm_num,
+                                                                                   image_name=image_path))
+        secs = time.monotonic() - sfm_start
+        if response.response_status.status_code != platform_ndk_pb2.ResponseCode.NDK_SUCCESS:
+            error_msg = response.response_status.error_msg
+            self._sfm_progress(sfm_num, 'failed', start, '({:.1f}s) {}'.format(secs, error_msg))
+            return False, secs, error_msg
+        self._sfm_progress(sfm_num, 'done', start, '({:.1f}s)'.format(secs))
+        return True, secs, ''
+
+    def install_sfm_firmware(self, stub, image_path, concurrency=None):
+        """
+        Installs the SFM FPGA image in every SFM, up to concurrency at once
+        (sfm_fw_concurrency() by default), printing each SFM's phase as it changes and a summary at the end
+
+        Returns:
+            A dict of sfm number to (installed, secs, error message)
+        """
+        if concurrency is None:
+            concurrency = sfm_fw_concurrency()
+        concurrency = max(1, min(concurrency, NOKIA_MAX_SFM_NO))
+        self._progress_lock = threading.Lock()
+        start = time.monotonic()
+        results = {}
+        print('Installing {} in {} SFMs, {} at a time'.format(image_path, NOKIA_MAX_SFM_NO, concurrency))
+        with futures.ThreadPoolExecutor(max_workers=concurrency) as executor:
+            jobs = {}
+            for sfm_num in range(1, NOKIA_MAX_SFM_NO+1):
+                self._sfm_progress(sfm_num, 'queued', start)
+                jobs[executor.submit(self._install_sfm_firmware, stub, sfm_num, image_path, start)] = sfm_num
+            for job in futures.as_completed(jobs):
+                try:
+                    results[jobs[job]] = job.result()
+                except Exception as e:
+                    # one SFM must not hide the others' results
+                    results[jobs[job]] = (False, 0.0, str(e))
+
+        failed = [sfm_num for sfm_num, (ok, secs, error_msg) in sorted(results.items()) if not ok]
+        for sfm_num, (ok, secs, error_msg) in sorted(results.items()):
+            print('SFM{}: {} in {:.1f}s{}'.format(sfm_num, 'installed' if ok else 'FAILED', secs,
+                                                  ', ' + error_msg if error_msg else ''))
+        print('SFM firmware install: {} of {} installed in {:.1f}s'.format(
+            NOKIA_MAX_SFM_NO - len(failed), NOKIA_MAX_SFM_NO, time.monotonic() - start))
+        return results
+
     def install_firmware(self, image_path):
         """
         Installs firmware to the component
@@ -161,28 +263,28 @@ class Component(ComponentBase):
               print('Firmware install is not supported for {}'.format(self.name))
               return False
 
+        if self.dev_type == platform_ndk_pb2.HW_FIRMWARE_DEVICE_FPGA3 and NOKIA_SFM_FW_DRY_RUN is not None:
+            results = self.install_sfm_firmware(SfmFirmwareDryRunStub(NOKIA_SFM_FW_DRY_RUN), image_path)
+            return all(ok for ok, secs, error_msg in results.values())
 
         channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_FIRMWARE_SERVICE)
         if not channel or not stub:
             return False
-        install_fail = True
+        install_ok = True
         if self.dev_type == platform_ndk_pb2.HW_FIRMWARE_DEVICE_FPGA3:
-           for sfm_num in range(1, NOKIA_MAX_SFM_NO+1):
-              ret, response = nokia_common.try_grpc(stub.HwFirmwareUpdate,
-                                platform_ndk_pb2.ReqHwFirmwareInfoPb(dev_type=self.dev_type, sfm_no=sfm_num, image_name = image_path))
-              if response.response_status.status_code != platform_ndk_pb2.ResponseCode.NDK_SUCCESS:
-                 print(response.response_status.error_msg)
-                 install_fail  = False
+           # the channel is shared by the install threads
+           results = self.install_sfm_firmware(stub, image_path)
+           install_ok = all(ok for ok, secs, error_msg in results.values())
         else:
           ret, response = nokia_common.try_grpc(stub.HwFirmwareUpdate,
                                 platform_ndk_pb2.ReqHwFirmwareInfoPb(dev_type=self.dev_type, image_name = image_path))
           if response.response_status.status_code != platform_ndk_pb2.ResponseCode.NDK_SUCCESS:
              print(response.response_status.error_msg)
-             return False
-        if install_fail == True:
-           print('Firmware install for {} with image {} is completed'.format(self.name,image_path))
+             install_ok = False
         nokia_common.channel_shutdown(channel)
-        return True
+        if install_ok == True:
+           print('Firmware install for {} with image {} is completed'.format(self.name,image_path))
+        return install_ok
 
     def update_firmware(self, image_path):
         """
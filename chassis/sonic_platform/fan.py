@@ -11,6 +11,7 @@ try:
     import time
     from sonic_platform_base.fan_base import FanBase
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_inventory
     from platform_ndk import platform_ndk_pb2
 except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
@@ -50,15 +51,17 @@ class Fan(FanBase):
         self.direction = Fan.FAN_DIRECTION_EXHAUST
         self.timestamp = 0
 
-    def _get_fan_info(self):
+    def _fan_info_is_due(self):
         # Return the default value if it is not a CPM
         if self.is_cpm == 0:
-            return
+            return False
+        return self.timestamp == 0 or (time.time() - self.timestamp >= 10)
 
-        current_time = time.time()
-        if self.timestamp != 0 and (current_time - self.timestamp < 10):
+    def _get_fan_info(self):
+        if not self._fan_info_is_due():
             return
 
+        current_time = time.time()
         channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_FAN_SERVICE)
         if not channel or not stub:
             self._reset_fan_info()
@@ -68,7 +71,13 @@ class Fan(FanBase):
         ret, response = nokia_common.try_grpc(stub.GetFanTrayInfo,
                                               platform_ndk_pb2.ReqFanTrayOpsPb(idx=req_idx))
         nokia_common.channel_shutdown(channel)
+        self._set_fan_info(ret, response, current_time)
 
+    def _set_fan_info(self, ret, response, current_time):
+        """
+        Caches a GetFanTrayInfo answer, also used by the chassis' batched
+        fan tray operations
+        """
         if ret is False:
             self._reset_fan_info()
             return
@@ -160,6 +169,7 @@ class Fan(FanBase):
         if ret is False:
             return speed
         speed = response.fan_speed_actual.fantray_speed
+        nokia_inventory.first_sample('fan')
         return speed
 
     def get_speed_tolerance(self):
@@ -10,10 +10,14 @@
 try:
     from sonic_platform_base.module_base import ModuleBase
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_inventory
     from platform_ndk import platform_ndk_pb2
     from sonic_platform.eeprom import Eeprom
     from sonic_py_common import daemon_base, device_info
     from swsscommon import swsscommon
+    import ast
+    import os
+    import threading
     import time
     from sonic_py_common.logger import Logger
 
@@ -37,6 +41,116 @@ EEPROM_SERIAL = '0x23'
 EEPROM_BASE_MAC = '0x24'
 NOKIA_MODULE_HWSKU_INFO_TABLE = 'NOKIA_MODULE_HWSKU_INFO_TABLE'
 NOKIA_MODULE_HWSKU_INFO_FIELD = 'hwsku_info'
+NOKIA_MODULE_BULK_INFO_CACHE_SECS = 5
+# a failed GetModuleBulkInfo is retried after a backoff doubling up to this
+NOKIA_MODULE_BULK_INFO_RETRY_MAX_SECS = 10
+# line card EEPROM rows are re-read this often when keyspace notifications
+# are unavailable
+NOKIA_MODULE_EEPROM_INFO_POLL_SECS = 60
+
+# one CHASSIS_STATE_DB connection per process, shared by all modules and
+# threads: every use of it, not only its creation, holds the lock
+_chassis_state_db = None
+_chassis_state_db_pid = None
+_chassis_state_db_lock = threading.RLock()
+
+
+def _get_chassis_state_db():
+    global _chassis_state_db, _chassis_state_db_pid
+    with _chassis_state_db_lock:
+        # a forked child must not share the parent's socket
+        if _chassis_state_db is None or _chassis_state_db_pid != os.getpid():
+            _chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
+            _chassis_state_db_pid = os.getpid()
+        return _chassis_state_db
+
+
+def _parse_eeprom_info(key, fvs):
+    # stored as str(dict) by the line card, see Chassis.get_eeprom()
+    try:
+        eeprom_info = ast.literal_eval(dict(fvs)['eeprom_info'])
+    except (KeyError, ValueError, SyntaxError) as e:
+        logger.log_warning("Invalid {}|{} eeprom_info: {}".format(NOKIA_MODULE_EEPROM_INFO_TABLE, key, e))
+        return None
+    if not isinstance(eeprom_info, dict):
+        return None
+    return eeprom_info
+
+
+class ModuleEepromInfoCache():
+    """
+    Parsed NOKIA_MODULE_EEPROM_INFO_TABLE rows, kept up to date by keyspace
+    notifications and polled when those are unavailable
+    """
+    def __init__(self):
+        # the subscriber and the reads use the shared connection
+        self.lock = _chassis_state_db_lock
+        self.pid = None
+        self.sel = None
+        self.subscriber = None
+        # {key: (eeprom_info or None, time read)}
+        self.entries = {}
+
+    def _apply_updates(self, updates):
+        for key, op, fvs in updates:
+            if op == 'SET':
+                self.entries[key] = (_parse_eeprom_info(key, fvs), time.monotonic())
+            elif op == 'DEL':
+                self.entries.pop(key, None)
+
+    def _subscribe(self):
+        self.pid = os.getpid()
+        self.sel = None
+        self.subscriber = None
+        self.entries = {}
+        try:
+            subscriber = swsscommon.SubscriberStateTable(_get_chassis_state_db(), NOKIA_MODULE_EEPROM_INFO_TABLE)
+        except Exception as e:
+            logger.log_warning('{} notifications unavailable, polling: {}'.format(NOKIA_MODULE_EEPROM_INFO_TABLE, e))
+            return
+        self.sel = swsscommon.Select()
+        self.sel.addSelectable(subscriber)
+        self.subscriber = subscriber
+        # the subscriber starts with the table's current content
+        self._apply_updates(subscriber.pops())
+
+    def _drain(self):
+        # pending notifications without blocking, bounded per lookup
+        for i in range(64):
+            state, selectable = self.sel.select(0)
+            if state == swsscommon.Select.TIMEOUT:
+                return
+            if state != swsscommon.Select.OBJECT:
+                logger.log_warning('CHASSIS_STATE_DB select failed, resyncing module eeprom info')
+                self._subscribe()
+                return
+            self._apply_updates(self.subscriber.pops())
+
+    def _read(self, key):
+        table = swsscommon.Table(_get_chassis_state_db(), NOKIA_MODULE_EEPROM_INFO_TABLE)
+        status, fvs = table.get(key)
+        self.entries[key] = (_parse_eeprom_info(key, fvs) if status else None, time.monotonic())
+
+    def get(self, key, refresh=False):
+        """
+        Returns a copy of the parsed eeprom info of key or None
+        :param refresh: re-read the row, e.g. after the module was inserted
+        """
+        with self.lock:
+            if self.pid != os.getpid():
+                self._subscribe()
+            if self.subscriber is not None:
+                self._drain()
+            entry = self.entries.get(key)
+            if refresh or entry is None or \
+                    (self.subscriber is None and time.monotonic() - entry[1] > NOKIA_MODULE_EEPROM_INFO_POLL_SECS):
+                self._read(key)
+                entry = self.entries[key]
+            return dict(entry[0]) if entry[0] is not None else None
+
+
+_module_eeprom_info_cache = ModuleEepromInfoCache()
+
 
 class Module(ModuleBase):
     """Nokia IXR-7250 Platform-specific Module class"""
@@ -52,14 +166,24 @@ class Module(ModuleBase):
         self._is_cpm = is_cpm
         self.eeprom = None
         self.sfm_module_eeprom = None
-        if nokia_common._get_my_slot() == module_slot:
+        # the slot this card is in, re-read by the bulk info fetch if unknown
+        self.my_slot = nokia_common._get_my_slot()
+        if self.my_slot == module_slot:
             # my own slot
             self.eeprom = Eeprom()
         elif module_type == ModuleBase.MODULE_TYPE_FABRIC:
             self.sfm_module_eeprom = module_eeprom
         self.timestamp = 0
+        self.bulk_info_lock = threading.RLock()
+        self.bulk_info_last_usecs = 0
+        self.bulk_info_max_usecs = 0
+        self.bulk_info_failures = 0
+        self.bulk_info_backoff = 0
+        self.bulk_info_retry_time = 0
         self.midplane = ""
         self.midplane_status = False
+        # the line card's eeprom row is re-read when it (re)appears
+        self.eeprom_info_presence = False
         self.reset()
 
     def reset(self):
@@ -69,9 +193,15 @@ class Module(ModuleBase):
         self.description = "Unavailable"
         self.sfm_module_eeprom = None
 
-    def _get_sfm_eeprom(self):
+    def _get_sfm_eeprom(self, sfm_eeprom_list=None):
+        """
+        Returns this SFM's entry of sfm_eeprom_list, fetched if not given
+        """
         if self.get_type() == ModuleBase.MODULE_TYPE_FABRIC:
-            sfm_eeprom_list = nokia_common._get_sfm_eeprom_info_list()
+            if sfm_eeprom_list is None:
+                sfm_eeprom_list = nokia_common._get_sfm_eeprom_info_list()
+            if sfm_eeprom_list is None:
+                return None
             i = 0
             while i < len(sfm_eeprom_list):
                 eeprom_info = sfm_eeprom_list[i]
@@ -107,100 +237,153 @@ class Module(ModuleBase):
                  "value": {
                  "eeprom_info": "{'0x24': '40:7C:7D:BB:27:21', '0x23': 'EAG2-02-143'}"
            }
+        The parsed rows are cached per process, see ModuleEepromInfoCache.
         """
-        if self.get_presence():
-            chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
-            nokia_lc_tbl = swsscommon.Table(chassis_state_db, NOKIA_MODULE_EEPROM_INFO_TABLE)
-            key=self.get_name()
-            status, fvs = nokia_lc_tbl.get(key)
-            if status:
-                eeprom_info= dict(fvs)
-                return eval(eeprom_info['eeprom_info'])
-        return None
-    
+        presence = self.get_presence()
+        refresh = presence and not self.eeprom_info_presence
+        self.eeprom_info_presence = presence
+        if not presence:
+            return None
+        return _module_eeprom_info_cache.get(self.get_name(), refresh)
+
     def _update_module_hwsku_info_to_supervisor(self, default):
         if self.get_type() != self.MODULE_TYPE_LINE or self._is_cpm:
             return
         else:
-            chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
-            nokia_hwsku_tbl = swsscommon.Table(chassis_state_db, NOKIA_MODULE_HWSKU_INFO_TABLE)
             hwsku = device_info.get_hwsku()
             if hwsku is None:
                 self.description = default
             else:
                 self.description = hwsku
             module_fvs = swsscommon.FieldValuePairs([(NOKIA_MODULE_HWSKU_INFO_FIELD, str(self.description))]) 
-            nokia_hwsku_tbl.set(self.get_name(), module_fvs)
+            with _chassis_state_db_lock:
+                nokia_hwsku_tbl = swsscommon.Table(_get_chassis_state_db(), NOKIA_MODULE_HWSKU_INFO_TABLE)
+                nokia_hwsku_tbl.set(self.get_name(), module_fvs)
         return None
     
     def _get_lc_module_description(self):
-        chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
-        nokia_hwsku_tbl = swsscommon.Table(chassis_state_db, NOKIA_MODULE_HWSKU_INFO_TABLE)
-        status, fvs = nokia_hwsku_tbl.get(self.module_name)
+        with _chassis_state_db_lock:
+            nokia_hwsku_tbl = swsscommon.Table(_get_chassis_state_db(), NOKIA_MODULE_HWSKU_INFO_TABLE)
+            status, fvs = nokia_hwsku_tbl.get(self.module_name)
         if status:
             hwsku_info = dict(fvs)
             return hwsku_info[NOKIA_MODULE_HWSKU_INFO_FIELD]
         return None
 
-    def _get_module_bulk_info(self):
-        """
-        Get module bulk info and cache it for 5 seconds to optimize the chassisd update which is in
-        10 seconds intervak periodical query
-        """
+    def _module_bulk_info_is_fresh(self, current_time):
         # No need to grpc call for supervisor card once it has been updated once
         if self.get_type() == self.MODULE_TYPE_SUPERVISOR:
             if self.oper_status == ModuleBase.MODULE_STATUS_ONLINE:
                 return True
 
-        current_time = time.time()
-        if current_time > self.timestamp and current_time - self.timestamp <= 5:
-            return True
+        return (current_time > self.timestamp and current_time - self.timestamp <= NOKIA_MODULE_BULK_INFO_CACHE_SECS)
+
+    def _module_bulk_info_is_due(self, current_time):
+        # stale and not backing off after a failed fetch
+        if self._module_bulk_info_is_fresh(current_time):
+            return False
+        return current_time >= self.bulk_info_retry_time
 
+    def _fetch_module_bulk_info(self, timeout=None):
+        """
+        Issue GetModuleBulkInfo for this module without touching any state, so
+        that it can run on a worker thread. Returns (response or None, usecs)
+        """
+        start = time.monotonic()
         channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_CHASSIS_SERVICE)
         if not channel or not stub:
-            return False
+            return None, int((time.monotonic() - start) * 1000000)
+        if self.my_slot == nokia_common.NOKIA_INVALID_SLOT_NUMBER and \
+                self.get_type() == self.MODULE_TYPE_LINE and not self._is_cpm:
+            ret, response = nokia_common.try_grpc(stub.GetMySlot, platform_ndk_pb2.ReqModuleInfoPb(), timeout)
+            if ret:
+                self.my_slot = response.my_slot
         platform_module_type = self.get_platform_type()
         ret, response = nokia_common.try_grpc(
             stub.GetModuleBulkInfo,
-            platform_ndk_pb2.ReqModuleInfoPb(module_type=platform_module_type, hw_slot=self._get_hw_slot()))
+            platform_ndk_pb2.ReqModuleInfoPb(module_type=platform_module_type, hw_slot=self._get_hw_slot()),
+            timeout)
         nokia_common.channel_shutdown(channel)
+        usecs = int((time.monotonic() - start) * 1000000)
         if ret is False:
-            return False
-        module_info = response.module_info
-        self.oper_status = nokia_common.hw_module_status_name(module_info.status)
-        self.midplane_ip = module_info.midplane_ip
-        self.midplane_status = module_info.midplane_status
-        if self.oper_status == ModuleBase.MODULE_STATUS_EMPTY:
-            self.reset()
+            return None, usecs
+        return response, usecs
+
+    def _record_module_bulk_info_latency(self, usecs, ok):
+        self.bulk_info_last_usecs = usecs
+        self.bulk_info_max_usecs = max(self.bulk_info_max_usecs, usecs)
+        if ok:
+            self.bulk_info_backoff = 0
+            self.bulk_info_retry_time = 0
         else:
-            if self.get_type() == self.MODULE_TYPE_FABRIC:
-                self.sfm_module_eeprom = self._get_sfm_eeprom()
-
-            self.chassis_type = module_info.chassis_type
-            self.description = module_info.name
-            if module_info.name in DESCRIPTION_MAPPING:
-                self.description = DESCRIPTION_MAPPING[module_info.name]
-                if platform_module_type == platform_ndk_pb2.HwModuleType.HW_MODULE_TYPE_CONTROL:
-                    if self.chassis_type == platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_IXR6:
-                        self.description = "Nokia-IXR7250E-SUP-6"
-
-            if self.get_type() == self.MODULE_TYPE_LINE:
-                if self._is_cpm:
-                    desc = self._get_lc_module_description()
-                    if desc is not None:
-                        self.description = desc
-                else:
-                    if nokia_common._get_my_slot() == self.hw_slot:
-                        self._update_module_hwsku_info_to_supervisor(self.description)
-                
-            if module_info.num_asic != 0:
-                i = 0
-                self.asic_list = []
-                while i < len(module_info.pcie_info.asic_entry):
-                    asic_info = module_info.pcie_info.asic_entry[i]
-                    self.asic_list.append((str(asic_info.asic_idx), str(asic_info.asic_pcie_id)))
-                    i += 1
-        self.timestamp = current_time
+            # the previous state stays stale, getters use it until the retry
+            self.bulk_info_failures += 1
+            self.bulk_info_backoff = min(max(2 * self.bulk_info_backoff, 1), NOKIA_MODULE_BULK_INFO_RETRY_MAX_SECS)
+            self.bulk_info_retry_time = time.time() + self.bulk_info_backoff
+
+    def _apply_module_bulk_info(self, response, current_time, sfm_eeprom_list=None):
+        """
+        Caches a GetModuleBulkInfo response. The chassis passes the SFM
+        eeprom list fetched once for all modules; without it a fabric
+        module fetches it itself.
+        """
+        with self.bulk_info_lock:
+            module_info = response.module_info
+            platform_module_type = self.get_platform_type()
+            self.oper_status = nokia_common.hw_module_status_name(module_info.status)
+            self.midplane_ip = module_info.midplane_ip
+            self.midplane_status = module_info.midplane_status
+            if self.oper_status == ModuleBase.MODULE_STATUS_EMPTY:
+                self.reset()
+            else:
+                if self.get_type() == self.MODULE_TYPE_FABRIC:
+                    sfm_eeprom = self._get_sfm_eeprom(sfm_eeprom_list)
+                    if sfm_eeprom is not None:
+                        self.sfm_module_eeprom = sfm_eeprom
+
+                self.chassis_type = module_info.chassis_type
+                self.description = module_info.name
+                if module_info.name in DESCRIPTION_MAPPING:
+                    self.description = DESCRIPTION_MAPPING[module_info.name]
+                    if platform_module_type == platform_ndk_pb2.HwModuleType.HW_MODULE_TYPE_CONTROL:
+                        if self.chassis_type == platform_ndk_pb2.HwChassisType.HW_CHASSIS_TYPE_IXR6:
+                            self.description = "Nokia-IXR7250E-SUP-6"
+
+                if self.get_type() == self.MODULE_TYPE_LINE:
+                    if self._is_cpm:
+                        desc = self._get_lc_module_description()
+                        if desc is not None:
+                            self.description = desc
+                    else:
+                        if self.my_slot == self.hw_slot:
+                            self._update_module_hwsku_info_to_supervisor(self.description)
+
+                if module_info.num_asic != 0:
+                    i = 0
+                    self.asic_list = []
+                    while i < len(module_info.pcie_info.asic_entry):
+                        asic_info = module_info.pcie_info.asic_entry[i]
+                        self.asic_list.append((str(asic_info.asic_idx), str(asic_info.asic_pcie_id)))
+                        i += 1
+            self.timestamp = current_time
+
+    def _get_module_bulk_info(self):
+        """
+        Get module bulk info and cache it for 5 seconds to optimize the chassisd update which is in
+        10 seconds intervak periodical query. On the supervisor the chassis refreshes all modules
+        at once, see Chassis.refresh_module_bulk_info()
+        """
+        current_time = time.time()
+        if self._module_bulk_info_is_fresh(current_time):
+            return True
+        if not self._module_bulk_info_is_due(current_time):
+            return False
+
+        response, usecs = self._fetch_module_bulk_info()
+        self._record_module_bulk_info_latency(usecs, response is not None)
+        if response is None:
+            return False
+        self._apply_module_bulk_info(response, current_time)
         return True
 
     def get_name(self):
@@ -269,6 +452,7 @@ class Module(ModuleBase):
             string: The status-string of the module
         """
         self._get_module_bulk_info()
+        nokia_inventory.first_sample('module')
         return self.oper_status
 
     def get_position_in_parent(self):
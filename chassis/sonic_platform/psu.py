@@ -11,6 +11,7 @@ try:
     import time
     from sonic_platform_base.psu_base import PsuBase
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_inventory
     from platform_ndk import platform_ndk_pb2
 except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
@@ -168,6 +169,7 @@ class Psu(PsuBase):
         if self._get_psu_bulk_info() is False:
             return False
         else:
+            nokia_inventory.first_sample('psu')
             return self.presence
 
     def get_status(self):
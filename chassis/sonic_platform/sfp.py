@@ -11,6 +11,8 @@ try:
     # from sonic_platform_base.sfp_base import SfpBase
     from sonic_platform_base.sonic_xcvr.sfp_optoe_base import SfpOptoeBase
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_mdipc_stats
+    from platform_ndk import nokia_replay
     from platform_ndk import platform_ndk_pb2
     from sonic_py_common.logger import Logger
     from sonic_py_common import device_info
@@ -46,7 +48,9 @@ DIRECT_TYPE = platform_ndk_pb2.ReqSfpEepromType.SFP_EEPROM_DIRECT
 
 # Module Direct IPC attributes
 # MDIPC_BASE_NAME = '/dev/shm/MDIPC'
-MDIPC_BASE_NAME = '/var/run/redis/MDIPC'
+# NOKIA_MDIPC_BASE_NAME points the client at another responder, e.g.
+# platform_tests/mdipc_sim.py for offline testing
+MDIPC_BASE_NAME = os.environ.get('NOKIA_MDIPC_BASE_NAME', '/var/run/redis/MDIPC')
 MDIPC_NUM_CHANNELS = 6
 
 MDIPC_OWN_NDK = 0x5A5A3C3C
@@ -57,10 +61,87 @@ MDIPC_OWN_NOS_RSP = 0xCBCBAF5F
 MDIPC_READ  = 0
 MDIPC_WRITE = 1
 MDIPC_PRESENCE = 2
+MDIPC_PRESENCE_BULK = 3
 MDIPC_RSP_SUCCESS = 0
 MDIPC_RSP_FAIL = 1
 MDIPC_RSP_NOTPRESENT = 2
 
+# MDIPC_PRESENCE_BULK response: presence bitmap (bit N-1 is port N) followed by
+# a one byte, wrapping, presence change generation per port.  Both must fit in
+# the 128 byte data window.
+MDIPC_PRESENCE_BULK_MAX_PORTS = 113
+
+MDIPC_OP_STAT_CLASS = {
+    MDIPC_READ: nokia_mdipc_stats.STAT_OP_READ,
+    MDIPC_WRITE: nokia_mdipc_stats.STAT_OP_WRITE,
+    MDIPC_PRESENCE: nokia_mdipc_stats.STAT_OP_PRESENCE,
+    MDIPC_PRESENCE_BULK: nokia_mdipc_stats.STAT_OP_PRESENCE
+}
+
+# Request classes in priority order. Each class may only use its channels,
+# scanned in the order given: the last channel is reserved for control
+# (writes, e.g. the CMIS state machine), bulk reads are kept to the first
+# MDIPC_BULK_CHANNELS so a CLI dump cannot starve DOM polling and presence,
+# which take the channels bulk cannot use first.
+MDIPC_CLASS_CONTROL = nokia_mdipc_stats.REQ_CLASS_CONTROL
+MDIPC_CLASS_PRESENCE = nokia_mdipc_stats.REQ_CLASS_PRESENCE
+MDIPC_CLASS_DOM = nokia_mdipc_stats.REQ_CLASS_DOM
+MDIPC_CLASS_BULK = nokia_mdipc_stats.REQ_CLASS_BULK
+MDIPC_CONTROL_CHANNEL = MDIPC_NUM_CHANNELS - 1
+MDIPC_BULK_CHANNELS = 3
+MDIPC_CLASS_CHANNELS = {
+    MDIPC_CLASS_CONTROL: [MDIPC_CONTROL_CHANNEL] + list(range(MDIPC_CONTROL_CHANNEL)),
+    MDIPC_CLASS_PRESENCE: list(reversed(range(MDIPC_CONTROL_CHANNEL))),
+    MDIPC_CLASS_DOM: list(reversed(range(MDIPC_CONTROL_CHANNEL))),
+    MDIPC_CLASS_BULK: list(range(MDIPC_BULK_CHANNELS))
+}
+# the higher classes a class holds off for while one of their requests
+# waits: only those that compete for one of its channels
+MDIPC_CLASS_YIELDS_TO = {
+    req_class: tuple(higher for higher in range(req_class)
+                     if set(MDIPC_CLASS_CHANNELS[higher]) & set(MDIPC_CLASS_CHANNELS[req_class]))
+    for req_class in MDIPC_CLASS_CHANNELS
+}
+MDIPC_OP_REQ_CLASS = {
+    MDIPC_WRITE: MDIPC_CLASS_CONTROL,
+    MDIPC_PRESENCE: MDIPC_CLASS_PRESENCE,
+    MDIPC_PRESENCE_BULK: MDIPC_CLASS_PRESENCE
+}
+# reads of these processes are DOM polling, of any other (sfputil, show
+# commands) bulk; NOKIA_MDIPC_READ_CLASS=<class name> overrides
+MDIPC_DOM_PROCESSES = ('xcvrd', 'thermalctld')
+# how long a request waits for one of its class' channels, lower classes
+# yield to higher ones and wait longer
+MDIPC_CLASS_WAIT_SECS = {
+    MDIPC_CLASS_CONTROL: 0.2,
+    MDIPC_CLASS_PRESENCE: 0.2,
+    MDIPC_CLASS_DOM: 0.5,
+    MDIPC_CLASS_BULK: 2.0
+}
+# a busy channel is polled again after a backoff doubling from the min
+# to the max, so waiters do not spin on the shared memory
+MDIPC_CHANNEL_RETRY_MIN_SECS = 0.0005
+MDIPC_CHANNEL_RETRY_MAX_SECS = 0.01
+
+
+def _mdipc_read_class():
+    name = os.environ.get('NOKIA_MDIPC_READ_CLASS')
+    if name in nokia_mdipc_stats.REQ_CLASS_NAMES:
+        return nokia_mdipc_stats.REQ_CLASS_NAMES.index(name)
+    process = os.path.basename(sys.argv[0]) if sys.argv and sys.argv[0] else ''
+    return MDIPC_CLASS_DOM if process in MDIPC_DOM_PROCESSES else MDIPC_CLASS_BULK
+
+# fallback port table size if the card type is not known yet
+NOKIA_SFP_DEFAULT_MAX_PORTS = 100
+# presence snapshot is reused by get_presence() for this long (seconds)
+PRESENCE_SNAPSHOT_HOLDOFF = 1.0
+# a bulk presence request that got no answer (timeout, no free channel or a
+# malformed reply) is retried after a backoff doubling up to this (seconds)
+PRESENCE_BULK_RETRY_MAX_SECS = 30.0
+
+# per thread: whether the last msg_send() got an answer from the NDK
+_mdipc_local = threading.local()
+
 
 class MDIPC_CHAN():
     def __init__(self, chan_index):
@@ -100,6 +181,15 @@ class MDIPC():
     initialized = False
     lock_held = False
     signals_initialized = False
+    # shared memory stats, see 'nokia_cmd show mdipc-stats'
+    shm_stats = None
+
+    @staticmethod
+    def stats():
+        # a forked child gets its own stats file
+        if (MDIPC.shm_stats is None) or (MDIPC.shm_stats.pid != os.getpid()):
+            MDIPC.shm_stats = nokia_mdipc_stats.MdipcStats()
+        return MDIPC.shm_stats
 
     def __init__(self):
         pid = os.getpid()
@@ -107,13 +197,18 @@ class MDIPC():
         if MDIPC.initialized is True:
             logger.log_warning("MDIPC ({} {}): {} channels already initialized".format(pid, tid, MDIPC_NUM_CHANNELS))
             return
-        for x in range(0, MDIPC_NUM_CHANNELS):
-            chan = MDIPC_CHAN(x)
-            MDIPC.channels.append(chan)
+        # replayed exchanges need no shared memory channels
+        if not nokia_replay.replaying():
+            for x in range(0, MDIPC_NUM_CHANNELS):
+                chan = MDIPC_CHAN(x)
+                MDIPC.channels.append(chan)
 
         MDIPC.initialized = True
         self.stat_no_channel_avail = 0
         self.Tmutex = threading.RLock()
+        self.read_class = _mdipc_read_class()
+        # threads of this process waiting for a channel, per class
+        self.waiting = [0] * len(nokia_mdipc_stats.REQ_CLASS_NAMES)
         logger.log_warning("MDIPC ({} {}): {} channels initialized".format(pid, tid, MDIPC_NUM_CHANNELS))
         if (pid == tid):
             self.install_sighandlers()
@@ -122,6 +217,8 @@ class MDIPC():
         pid = os.getpid()
         tid = threading.get_native_id()
         self.dump_stats()
+        if (MDIPC.shm_stats is not None) and (MDIPC.shm_stats.pid == pid):
+            MDIPC.shm_stats.close()
         logger.log_warning("MDIPC destruction ({} {})".format(pid, tid))
 
     def install_sighandlers(self):
@@ -164,20 +261,27 @@ class MDIPC():
             self.Plock_release()
 
     def Plock_acquire(self):
+        if not MDIPC.channels:
+            return
         fcntl.flock(MDIPC.channels[0].fd, fcntl.LOCK_EX)
         self.lock_held = True
 
     def Plock_release(self):
+        if not MDIPC.channels:
+            return
         fcntl.flock(MDIPC.channels[0].fd, fcntl.LOCK_UN)
         self.lock_held = False
 
-    def obtain_channel(self):
+    def obtain_channel(self, req_class=MDIPC_CLASS_CONTROL):
         pid = os.getpid()
         tid = threading.get_native_id()
         index = None
         self.Tmutex.acquire()        # thread protection
         self.Plock_acquire()         # process protection
-        for chan in MDIPC.channels:
+        for chan_index in MDIPC_CLASS_CHANNELS[req_class]:
+            chan = MDIPC.channels[chan_index]
+            if (chan.mm is None):
+                continue
             own = int.from_bytes(chan.mm[0:4],sys.byteorder)
             if (own == MDIPC_OWN_NOS):
                 ownerID = int.from_bytes(chan.mm[8:12],sys.byteorder)
@@ -185,6 +289,7 @@ class MDIPC():
                    if (chan.in_use == True):
                       msgID = int.from_bytes(chan.mm[4:8],sys.byteorder)
                       chan.stat_already_in_use += 1
+                      MDIPC.stats().count(chan.index, nokia_mdipc_stats.CHAN_ALREADY_IN_USE)
                       logger.log_error("obtain_channel({} {}): got chan.in_use while allocating chan {} with last msgID {} : count {}".format(pid, tid, chan.index, msgID, chan.stat_already_in_use))
                    chan.mm[0:4] = MDIPC_OWN_NOS_PREP.to_bytes(4, sys.byteorder)
                    chan.mm[8:12] = tid.to_bytes(4, sys.byteorder)
@@ -202,6 +307,44 @@ class MDIPC():
         self.Tmutex.release()
         return index
 
+    def higher_class_waiting(self, req_class):
+        return any(self.waiting[higher] for higher in MDIPC_CLASS_YIELDS_TO[req_class])
+
+    def wait_channel(self, req_class):
+        """
+        Obtains one of req_class' channels, retrying with backoff for up
+        to MDIPC_CLASS_WAIT_SECS. Threads of this process with a lower class
+        hold off while a higher class one waits for a channel they share.
+
+        Returns:
+            The channel index or None
+        """
+        if not self.higher_class_waiting(req_class):
+            index = self.obtain_channel(req_class)
+            if (index is not None):
+                return index
+
+        deadline = time.monotonic() + MDIPC_CLASS_WAIT_SECS[req_class]
+        with self.Tmutex:
+            self.waiting[req_class] += 1
+        retry_secs = MDIPC_CHANNEL_RETRY_MIN_SECS
+        try:
+            while True:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    break
+                time.sleep(min(retry_secs, remaining))
+                retry_secs = min(retry_secs * 2, MDIPC_CHANNEL_RETRY_MAX_SECS)
+                if self.higher_class_waiting(req_class):
+                    continue
+                index = self.obtain_channel(req_class)
+                if (index is not None):
+                    return index
+        finally:
+            with self.Tmutex:
+                self.waiting[req_class] -= 1
+        return None
+
     def free_channel(self, index, stat = None):
         pid = os.getpid()
         tid = threading.get_native_id()
@@ -233,17 +376,47 @@ class MDIPC():
         self.Plock_release()
         self.Tmutex.release()
         self.dump_stats()
+        if (MDIPC.shm_stats is not None) and (MDIPC.shm_stats.pid == pid):
+            MDIPC.shm_stats.close()
         logger.log_error("MDIPC termination handler({} {},{}): cleaned up".format(pid, tid, signum))
         # signal.signal(signum, self.sighandlers[signum])
         sys.exit()
 
-    def msg_send(self, op, hw_port_id, page, offset, num_bytes, data=None):
+    def msg_send(self, op, hw_port_id, page, offset, num_bytes, data=None, req_class=None):
+        """
+        req_class: MDIPC_CLASS_*, by default control for writes, presence
+        for presence ops and the process' read class for reads
+        """
+        _mdipc_local.answered = False
+        if nokia_replay.replaying():
+            status, ret_data = nokia_replay.replay_mdipc(op, hw_port_id, page, offset, num_bytes, data)
+            _mdipc_local.answered = status is not None
+            if status is None:
+                return MDIPC_RSP_FAIL, None
+            return status, ret_data
+        if (req_class is None):
+            req_class = MDIPC_OP_REQ_CLASS.get(op, self.read_class)
+        if not nokia_replay.recording():
+            return self._msg_send(op, hw_port_id, page, offset, num_bytes, data, req_class)
+
+        start = time.monotonic()
+        status, ret_data = self._msg_send(op, hw_port_id, page, offset, num_bytes, data, req_class)
+        nokia_replay.record_mdipc(op, hw_port_id, page, offset, num_bytes, data, status, ret_data,
+                                  time.monotonic() - start)
+        return status, ret_data
+
+    def _msg_send(self, op, hw_port_id, page, offset, num_bytes, data, req_class):
 
         start_time = int(time.monotonic_ns() / 1000)
-        index = self.obtain_channel()
+        index = self.wait_channel(req_class)
+        shm_stats = MDIPC.stats()
+        wait_time = int(time.monotonic_ns() / 1000) - start_time
+        shm_stats.record_wait(MDIPC_OP_STAT_CLASS.get(op, nokia_mdipc_stats.STAT_OP_READ), wait_time)
+        shm_stats.record_class_wait(req_class, wait_time, index is not None)
         if (index is None):
             self.stat_no_channel_avail += 1
-            logger.log_error("msg_send ({} {}): no free channel available!".format(os.getpid(), threading.get_native_id()))
+            shm_stats.count_global(nokia_mdipc_stats.GLOBAL_NO_CHANNEL_AVAIL)
+            logger.log_error("msg_send ({} {}): no free {} channel available!".format(os.getpid(), threading.get_native_id(), nokia_mdipc_stats.REQ_CLASS_NAMES[req_class]))
             # caller = inspect.stack(0)
             # logger.log_error(" msg_send ({} {}): call stack is: {}".format(os.getpid(), threading.get_native_id(), caller))            
             return MDIPC_RSP_FAIL, None
@@ -276,6 +449,8 @@ class MDIPC():
             pass
         elif (op == MDIPC_PRESENCE):
             pass
+        elif (op == MDIPC_PRESENCE_BULK):
+            pass
         else:
             logger.log_error("msg_send ({},{} {}): unknown op {} requested!".format(index, pid, tid, op))
             logger.log_error("          op {} msgID {} hw_port_id {} pg {} offset {} num_bytes {}".format(op, msgID, hw_port_id, page, offset, num_bytes))
@@ -286,6 +461,7 @@ class MDIPC():
         msg[0:4] = MDIPC_OWN_NDK.to_bytes(4, sys.byteorder)
         handoff_time = int(time.monotonic_ns() / 1000)
         MDIPC.channels[index].stat_num_msgs += 1
+        shm_stats.count(index, nokia_mdipc_stats.CHAN_MSGS)
 
         # wait for response now...
         timed_out = False
@@ -301,22 +477,27 @@ class MDIPC():
 
         done_time = int(time.monotonic_ns() / 1000)
         delta_time = done_time - handoff_time
+        shm_stats.record_rsp(index, MDIPC_OP_STAT_CLASS[op], page, delta_time)
         if (timed_out == True):
             MDIPC.channels[index].stat_num_timeouts += 1
+            shm_stats.count(index, nokia_mdipc_stats.CHAN_TIMEOUTS)
             logger.log_error("msg_send ({},{} {}): timeout ({}/{})! own {} : starttime {} handofftime {} endtime {} rsptime(us) {}".format(index, pid, tid, sleep_iters, MDIPC.channels[index].stat_num_timeouts, hex(int.from_bytes(msg[0:4],sys.byteorder)), start_time, handoff_time, done_time, delta_time))
             logger.log_error("          op {} msgID {} index {} pg {} offset {} num_bytes {}".format(op, msgID, hw_port_id, page, offset, num_bytes))
             self.free_channel(index)
             return MDIPC_RSP_FAIL, None
         else:
+            _mdipc_local.answered = True
             status = int.from_bytes(msg[32:36],sys.byteorder)
             if (delta_time >=  200000):
                MDIPC.channels[index].stat_long_rsp += 1
+               shm_stats.count(index, nokia_mdipc_stats.CHAN_LONG_RSP)
                # logger.log_warning("msg_send ({},{} {}): op {} msgID {} : index {} pg {} offset {} num_bytes {} : rsp status {} starttime {} handofftime {} endtime {} rsptime(us) {}".format(index, pid, tid, op, msgID, hw_port_id, page, offset, num_bytes, status, start_time, handoff_time, done_time, delta_time))
             
             ret_data = None
             if (status == MDIPC_RSP_SUCCESS):         # this also catches 'not present' responses to MDIPC_PRESENCE ops
                MDIPC.channels[index].stat_num_success += 1
-               if (op == MDIPC_READ):
+               shm_stats.count(index, nokia_mdipc_stats.CHAN_SUCCESS)
+               if (op == MDIPC_READ) or (op == MDIPC_PRESENCE_BULK):
                    # logger.log_debug("          op {} msgID {} index {} pg {} offset {} num_bytes {} ret_data {}".format(op, msgID, hw_port_id, page, offset, num_bytes, bytearray(msg[36:(36+num_bytes)])))
                    # copy data to prevent continued peering directly into mmap window
                    ret_data = bytearray(msg[36:(36+num_bytes)])
@@ -326,13 +507,17 @@ class MDIPC():
             elif (status == MDIPC_RSP_FAIL):
                if (op != MDIPC_PRESENCE):
                   MDIPC.channels[index].stat_num_fail += 1
+                  shm_stats.count(index, nokia_mdipc_stats.CHAN_FAIL)
                else:
                   MDIPC.channels[index].stat_num_success += 1       # this catches 'present' responses to MDIPC_PRESENCE ops
+                  shm_stats.count(index, nokia_mdipc_stats.CHAN_SUCCESS)
             elif (status == MDIPC_RSP_NOTPRESENT):
                MDIPC.channels[index].stat_num_notpresent += 1       # only for read/write ops that result in NOTPRESENT
+               shm_stats.count(index, nokia_mdipc_stats.CHAN_NOTPRESENT)
             else:
                MDIPC.channels[index].stat_num_unknown += 1
-            if (delta_time < MDIPC.channels[index].stat_min_rsp_wait) and (op != MDIPC_PRESENCE):
+               shm_stats.count(index, nokia_mdipc_stats.CHAN_UNKNOWN)
+            if (delta_time < MDIPC.channels[index].stat_min_rsp_wait) and (op != MDIPC_PRESENCE) and (op != MDIPC_PRESENCE_BULK):
                MDIPC.channels[index].stat_min_rsp_wait = delta_time
                logger.log_debug("**** msg_send ({},{} {}): op {} msgID {} new minrspwait {}".format(index, pid, tid, op, msgID, delta_time))
             if (delta_time > MDIPC.channels[index].stat_max_rsp_wait):
@@ -342,6 +527,44 @@ class MDIPC():
         self.free_channel(index)
         return status, ret_data
 
+    def last_answered(self):
+        """
+        True if the calling thread's last msg_send() got an NDK response,
+        False after a timeout, no free channel or a local error
+        """
+        return getattr(_mdipc_local, 'answered', False)
+
+    def presence_snapshot(self, num_ports):
+        """
+        Retrieves presence of ports 1..num_ports in a single MDIPC exchange
+
+        Returns:
+            A tuple (presence, generation, unsupported): lists indexed by port
+            (index 0 unused), or None, None and whether the NDK rejected the
+            bulk request (True) or it should be retried (False)
+        """
+        if (num_ports > MDIPC_PRESENCE_BULK_MAX_PORTS):
+            return None, None, True
+
+        bitmap_len = (num_ports + 7) // 8
+        status, data = self.msg_send(MDIPC_PRESENCE_BULK, 1, 0, 0, bitmap_len + num_ports)
+        if (status != MDIPC_RSP_SUCCESS):
+            # an NDK without bulk presence answers FAIL
+            return None, None, self.last_answered()
+        if (data is None) or (len(data) != bitmap_len + num_ports):
+            logger.log_warning("presence_snapshot ({} {}): short reply {} for {} ports".format(os.getpid(), threading.get_native_id(), None if data is None else len(data), num_ports))
+            return None, None, False
+        if (num_ports & 7) and (data[bitmap_len - 1] >> (num_ports & 7)):
+            logger.log_warning("presence_snapshot ({} {}): presence bitmap {} has bits beyond port {}".format(os.getpid(), threading.get_native_id(), bytes(data[:bitmap_len]).hex(), num_ports))
+            return None, None, False
+
+        presence = [False] * (num_ports + 1)
+        generation = [0] * (num_ports + 1)
+        for port in range(1, num_ports + 1):
+            presence[port] = bool(data[(port - 1) >> 3] & (1 << ((port - 1) & 7)))
+            generation[port] = data[bitmap_len + port - 1]
+        return presence, generation, False
+
 
 # caching modes
 CACHE_NORMAL  = 0
@@ -460,10 +683,115 @@ class Sfp(SfpOptoeBase):
     MDIPC_Initialized = False
     precache = False
     debug = False
-    # hardwire for max 100 ports per IMM
-    presence = RawArray('I', 100)
+    # shared port tables, allocated at import so that every process forked
+    # later shares them; alloc_port_tables() grows them for larger cards
+    # before the first fork
+    max_ports = 0
+    presence = None
+    presence_gen = None
+    ndk_presence_gen = None
+    forked = False
     sfp_event_live = RawValue('I', 0)
-    initialized = [False] * 100
+    initialized = []
+    bulk_presence_supported = True
+    bulk_presence_backoff = 0
+    bulk_presence_retry_ts = 0
+    presence_snapshot_ts = 0
+    presence_lock = threading.Lock()
+
+    @staticmethod
+    def alloc_port_tables(num_ports):
+        """
+        Size the shared per-port tables for a card with num_ports ports.
+        Must be called before xcvrd forks its helper processes so the
+        RawArrays stay shared; tables are indexed by 1-based port.
+        Growing them after a fork raises RuntimeError: the processes
+        forked earlier would keep tables nobody updates.
+        """
+        if (Sfp.presence is not None) and (num_ports <= Sfp.max_ports):
+            return
+        if (Sfp.forked):
+            logger.log_error("alloc_port_tables ({} {}): {} ports do not fit the {} port tables shared with forked processes".format(os.getpid(), threading.get_native_id(), num_ports, Sfp.max_ports))
+            raise RuntimeError("SFP port tables cannot grow to {} ports after a fork".format(num_ports))
+
+        presence = RawArray('I', num_ports + 1)
+        presence_gen = RawArray('I', num_ports + 1)
+        ndk_presence_gen = RawArray('I', num_ports + 1)
+        if (Sfp.presence is not None):
+            logger.log_warning("alloc_port_tables ({} {}): growing port tables from {} to {} ports".format(os.getpid(), threading.get_native_id(), Sfp.max_ports, num_ports))
+            for port in range(0, Sfp.max_ports + 1):
+                presence[port] = Sfp.presence[port]
+                presence_gen[port] = Sfp.presence_gen[port]
+                ndk_presence_gen[port] = Sfp.ndk_presence_gen[port]
+
+        Sfp.presence = presence
+        Sfp.presence_gen = presence_gen
+        Sfp.ndk_presence_gen = ndk_presence_gen
+        Sfp.initialized.extend([False] * (num_ports + 1 - len(Sfp.initialized)))
+        Sfp.max_ports = num_ports
+
+    @staticmethod
+    def refresh_presence_snapshot():
+        """
+        Refresh the shared presence table of all ports, using a single
+        MDIPC_PRESENCE_BULK exchange when the NDK supports it and one
+        MDIPC_PRESENCE exchange per port otherwise.  Ports whose presence
+        or NDK change generation moved get their page cache flushed.
+        While a failed bulk request backs off, presence is read per port;
+        a port whose request got no answer keeps its previous presence.
+        """
+        num_ports = Sfp.max_ports
+        with Sfp.presence_lock:
+            presence = None
+            ndk_gen = None
+            if (Sfp.bulk_presence_supported) and (time.monotonic() >= Sfp.bulk_presence_retry_ts):
+                presence, ndk_gen, unsupported = Sfp.MDIPC_hdl.presence_snapshot(num_ports)
+                if (presence is not None):
+                    Sfp.bulk_presence_backoff = 0
+                elif (unsupported):
+                    logger.log_warning("MDIPC ({} {}) bulk presence unsupported for {} ports, falling back to per-port presence".format(os.getpid(), threading.get_native_id(), num_ports))
+                    Sfp.bulk_presence_supported = False
+                else:
+                    Sfp.bulk_presence_backoff = min(max(2 * Sfp.bulk_presence_backoff, PRESENCE_SNAPSHOT_HOLDOFF), PRESENCE_BULK_RETRY_MAX_SECS)
+                    Sfp.bulk_presence_retry_ts = time.monotonic() + Sfp.bulk_presence_backoff
+                    logger.log_warning("MDIPC ({} {}) bulk presence failed, retrying in {}s".format(os.getpid(), threading.get_native_id(), Sfp.bulk_presence_backoff))
+
+            if (presence is None):
+                presence = [False] * (num_ports + 1)
+                for port in range(1, num_ports + 1):
+                    status, data = Sfp.MDIPC_hdl.msg_send(MDIPC_PRESENCE, port, 0, 0, 0)
+                    if (Sfp.MDIPC_hdl.last_answered()):
+                        presence[port] = bool(status)
+                    else:
+                        presence[port] = bool(Sfp.presence[port])
+
+            first_snapshot = (Sfp.presence_snapshot_ts == 0)
+            instances = {inst.index: inst for inst in Sfp.instances}
+            for port in range(1, num_ports + 1):
+                changed = False
+                if (ndk_gen is not None):
+                    delta = (ndk_gen[port] - Sfp.ndk_presence_gen[port]) & 0xff
+                    Sfp.ndk_presence_gen[port] = ndk_gen[port]
+                    if (delta != 0) and (first_snapshot is False):
+                        # catches a remove/insert that happened between two snapshots
+                        Sfp.presence_gen[port] += delta
+                        changed = True
+                lastPresence = bool(Sfp.presence[port])
+                if (presence[port] != lastPresence):
+                    if (changed is False):
+                        Sfp.presence_gen[port] += 1
+                    changed = True
+                Sfp.presence[port] = presence[port]
+
+                inst = instances.get(port)
+                if (changed is True) and (inst is not None):
+                    logger.log_warning("MDIPC ({} {}) presence snapshot: SFP{} changed from {} to {} gen {}".format(os.getpid(), threading.get_native_id(), port, lastPresence, presence[port], Sfp.presence_gen[port]))
+                    inst.page_cache_flush()
+                    if (presence[port]) and (Sfp.precache):
+                        logger.log_warning("caching page0 for SFP{} due to lastPresence {}".format(port, presence[port]))
+                        inst.cache_page0.cache_page()
+
+            Sfp.presence_snapshot_ts = time.monotonic()
 
     # used by sfp_event to synchronize presence info
     @staticmethod
@@ -476,6 +804,7 @@ class Sfp(SfpOptoeBase):
             if (inst.index == port):
                 inst.page_cache_flush()
                 lastPresence = Sfp.presence[inst.index]
+                Sfp.presence_gen[inst.index] += 1
 
                 if (status == '0'):
                     Sfp.presence[inst.index] = False
@@ -533,6 +862,9 @@ class Sfp(SfpOptoeBase):
                     logger.log_warning("SFP init ({} {}): MDIPC sighandlers initialized".format(pid, tid))
             logger.log_debug("SFP init ({} {}): Skipping MDIPC init".format(pid, tid))
 
+        if (index > Sfp.max_ports):
+            Sfp.alloc_port_tables(max(index, NOKIA_SFP_DEFAULT_MAX_PORTS))
+
         if (Sfp.initialized[index] == True):
             logger.log_error("SFP init ({} {}): Attempted reinitialization of index {} ignored".format(pid, tid, index))
             return
@@ -569,24 +901,13 @@ class Sfp(SfpOptoeBase):
         if (Sfp.sfp_event_live == True):
             # rely on SFP event subsystem notification of status change once it is running
             return bool(Sfp.presence[self.index])
-        else:
-            logger.log_debug("({} {}) getting MDIPC presence for SFP{}".format(os.getpid(), threading.get_native_id(), self.index))
 
-        status, data = Sfp.MDIPC_hdl.msg_send(MDIPC_PRESENCE, self.index, 0, 0, 0)
-        lastPresence = Sfp.presence[self.index]
+        # one snapshot answers a whole sweep of get_presence() calls
+        if ((time.monotonic() - Sfp.presence_snapshot_ts) >= PRESENCE_SNAPSHOT_HOLDOFF):
+            logger.log_debug("({} {}) refreshing MDIPC presence snapshot for SFP{}".format(os.getpid(), threading.get_native_id(), self.index))
+            Sfp.refresh_presence_snapshot()
 
-        if (lastPresence != status):
-            logger.log_warning("MDIPC ({} {}) get_presence status changed for SFP{} from {} to {}".format(os.getpid(), threading.get_native_id(), self.index, lastPresence, status))
-            Sfp.presence[self.index] = status
-            self.page_cache_flush()
-            if (status) and (Sfp.precache):
-                logger.log_warning("caching page0 for SFP{} due to lastPresence {}".format(self.index, status))
-                self.cache_page0.cache_page()
-
-        if (status):
-            return True
-        else:
-            return False
+        return bool(Sfp.presence[self.index])
 
     def get_cached_page(self, page):
         inst = self.page_cache[page]
@@ -1012,3 +1333,12 @@ class Sfp(SfpOptoeBase):
                 logger.log_warning("     data:    {}".format(bytes(write_buffer)))
 
         return True
+
+
+def _sfp_before_fork():
+    # the port tables are shared from now on, see Sfp.alloc_port_tables()
+    Sfp.forked = True
+
+
+Sfp.alloc_port_tables(NOKIA_SFP_DEFAULT_MAX_PORTS)
+os.register_at_fork(before=_sfp_before_fork)
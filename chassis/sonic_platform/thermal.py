@@ -11,6 +11,7 @@ try:
     import time
     from sonic_platform_base.thermal_base import ThermalBase
     from platform_ndk import nokia_common
+    from platform_ndk import nokia_inventory
     from platform_ndk import platform_ndk_pb2
 except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
@@ -134,6 +135,7 @@ class Thermal(ThermalBase):
             nearest thousandth of one degree Celsius, e.g. 30.125
         """
         self._get_all_temperature_info()
+        nokia_inventory.first_sample('thermal')
         return float("{:.3f}".format(self.thermal_temperature))
 
     def get_high_threshold(self):
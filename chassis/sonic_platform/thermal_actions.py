@@ -1,3 +1,4 @@
+import time
 from sonic_platform_base.sonic_thermal_control.thermal_action_base import ThermalPolicyActionBase
 from sonic_platform_base.sonic_thermal_control.thermal_json_object import thermal_json_object
 
@@ -7,12 +8,98 @@ from platform_ndk import platform_ndk_pb2
 
 logger = Logger('thermal_actions')
 
+SLOW_FAN_ACTION_MSECS = 1000
+
+
+def report_fan_action(action, results, start):
+    """
+    Logs the end-to-end latency and per-tray result of a chassis-wide fan
+    operation
+    """
+    msecs = int((time.monotonic() - start) * 1000)
+    failed = sorted(tray for tray, ok in results.items() if not ok)
+    msg = '{}: {} fan trays in {}ms'.format(action, len(results), msecs)
+    if failed:
+        logger.log_warning('{}, failed trays {}'.format(msg, failed))
+    elif msecs >= SLOW_FAN_ACTION_MSECS:
+        logger.log_warning(msg)
+    else:
+        logger.log_debug(msg)
+    return msecs
+
 
 @thermal_json_object('thermal.platform.publish')
 class PublishThermalAlgoAction(ThermalPolicyActionBase):
     """
-    Action to publish thermal information to platform
+    Action to publish thermal information to platform, disabled unless the
+    policy sets "publish". Only slots whose aggregates moved by hysteresis
+    degrees or more (any change for 0) since they were last sent are
+    published, and a slot is re-sent heartbeat seconds after the NDK last
+    accepted it. A slot that fails is retried on its own next cycle.
     """
+    # JSON field definition
+    JSON_FIELD_PUBLISH = 'publish'
+    JSON_FIELD_HYSTERESIS = 'hysteresis'
+    JSON_FIELD_HEARTBEAT = 'heartbeat'
+
+    LOG_INTERVAL_SECS = 3600
+
+    def __init__(self):
+        self.publish = False
+        self.hysteresis = 1
+        self.heartbeat = 300
+        # slot -> (curr, min, max, margin) last accepted by the NDK
+        self.published = {}
+        # slot -> time it was last accepted by the NDK
+        self.refreshed = {}
+        self.last_log = time.monotonic()
+        self.sent = 0
+        self.suppressed = 0
+        self.failed = 0
+
+    def load_from_json(self, json_obj):
+        """
+        Construct PublishThermalAlgoAction via JSON, all fields optional.
+        JSON example:
+            {
+                "type": "thermal.platform.publish"
+                "publish": "true"
+                "hysteresis": "1"
+                "heartbeat": "300"
+            }
+        :param json_obj: A JSON object representing a PublishThermalAlgoAction action.
+        :return:
+        """
+        if PublishThermalAlgoAction.JSON_FIELD_PUBLISH in json_obj:
+            publish_str = str(json_obj[PublishThermalAlgoAction.JSON_FIELD_PUBLISH]).lower()
+            if publish_str == 'true':
+                self.publish = True
+            elif publish_str == 'false':
+                self.publish = False
+            else:
+                raise ValueError('Invalid {} field value, please specify true of false'.
+                                 format(PublishThermalAlgoAction.JSON_FIELD_PUBLISH))
+        if PublishThermalAlgoAction.JSON_FIELD_HYSTERESIS in json_obj:
+            self.hysteresis = int(json_obj[PublishThermalAlgoAction.JSON_FIELD_HYSTERESIS])
+            if self.hysteresis < 0:
+                raise ValueError('PublishThermalAlgoAction invalid hysteresis value {} in JSON policy file'.
+                                 format(self.hysteresis))
+        if PublishThermalAlgoAction.JSON_FIELD_HEARTBEAT in json_obj:
+            self.heartbeat = int(json_obj[PublishThermalAlgoAction.JSON_FIELD_HEARTBEAT])
+            if self.heartbeat <= 0:
+                raise ValueError('PublishThermalAlgoAction invalid heartbeat value {} in JSON policy file'.
+                                 format(self.heartbeat))
+
+    def _changed(self, slot, values):
+        last = self.published.get(slot)
+        if last is None:
+            return True
+        # a hysteresis of 0 still needs a change
+        return any(value != last_value and abs(value - last_value) >= self.hysteresis
+                   for value, last_value in zip(values, last))
+
+    def get_counters(self):
+        return {'sent': self.sent, 'suppressed': self.suppressed, 'failed': self.failed}
 
     def execute(self, thermal_info_dict):
         """
@@ -29,21 +116,49 @@ class PublishThermalAlgoAction(ThermalPolicyActionBase):
         else:
             return
 
-        return
+        if not self.publish:
+            return
+
+        if ThermalInfo.INFO_NAME not in thermal_info_dict:
+            return
+        thermal_info_obj = thermal_info_dict[ThermalInfo.INFO_NAME]
 
-        if ThermalInfo.INFO_NAME in thermal_info_dict:
-            thermal_info_obj = thermal_info_dict[ThermalInfo.INFO_NAME]
+        now = time.monotonic()
+        updates = []
+        for slot, lc_info in thermal_info_obj.lc_thermal_dict.items():
+            values = (int(lc_info['curr_temp']), int(lc_info['min_temp']),
+                      int(lc_info['max_temp']), int(lc_info['margin_temp']))
+            refreshed = self.refreshed.get(slot)
+            if refreshed is None or (now - refreshed) >= self.heartbeat or self._changed(slot, values):
+                updates.append((slot, values))
+            else:
+                self.suppressed += 1
 
-            for slot, lc_info in thermal_info_obj.lc_thermal_dict.items():
+        if updates:
+            # all of this cycle's slots on one channel
+            channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_THERMAL_SERVICE)
+            if not channel or not stub:
+                self.failed += len(updates)
+                return
+            for slot, values in updates:
                 update_hwslot_temp = platform_ndk_pb2.UpdateTempInfoPb(
-                    slot_num=slot, current_temp=int(lc_info['curr_temp']), min_temp=int(lc_info['min_temp']),
-                    max_temp=int(lc_info['max_temp']), margin=int(lc_info['margin_temp']))
-                channel, stub = nokia_common.channel_setup(nokia_common.NOKIA_GRPC_THERMAL_SERVICE)
-                if not channel or not stub:
-                    continue
+                    slot_num=slot, current_temp=values[0], min_temp=values[1],
+                    max_temp=values[2], margin=values[3])
                 ret, response = nokia_common.try_grpc(stub.UpdateThermalHwSlot,
                                                       platform_ndk_pb2.ReqTempParamsPb(hwslot_temp=update_hwslot_temp))
-                nokia_common.channel_shutdown(channel)
+                if ret:
+                    self.published[slot] = values
+                    self.refreshed[slot] = now
+                    self.sent += 1
+                else:
+                    # not recorded, retried next cycle
+                    self.failed += 1
+            nokia_common.channel_shutdown(channel)
+
+        if now - self.last_log >= self.LOG_INTERVAL_SECS:
+            self.last_log = now
+            logger.log_info('Thermal algo publish: sent {} suppressed {} failed {}'.format(
+                self.sent, self.suppressed, self.failed))
 
 
 @thermal_json_object('fan.all.disable_algorithm')
@@ -56,6 +171,7 @@ class DisableFanAlgoAction(ThermalPolicyActionBase):
 
     def __init__(self):
         self.status = False
+        self.last_msecs = None
 
     def load_from_json(self, json_obj):
         """
@@ -96,9 +212,9 @@ class DisableFanAlgoAction(ThermalPolicyActionBase):
             return
 
         if FanInfo.INFO_NAME in thermal_info_dict:
-            for drawer in chassis.get_all_fan_drawers():
-                for fan in drawer.get_all_fans():
-                    fan.disable_fan_algorithm(self.status)
+            start = time.monotonic()
+            results = chassis.disable_all_fan_trays_algorithm(self.status)
+            self.last_msecs = report_fan_action('fan.all.disable_algorithm {}'.format(self.status), results, start)
 
 
 @thermal_json_object('fan.all.set_speed')
@@ -114,6 +230,7 @@ class SetFanSpeedAction(ThermalPolicyActionBase):
         Constructor of SetFanSpeedAction
         """
         self.speed = 50
+        self.last_msecs = None
 
     def load_from_json(self, json_obj):
         """
@@ -150,6 +267,6 @@ class SetFanSpeedAction(ThermalPolicyActionBase):
             return
 
         if FanInfo.INFO_NAME in thermal_info_dict:
-            for drawer in chassis.get_all_fan_drawers():
-                for fan in drawer.get_all_fans():
-                    fan.set_speed(self.speed)
+            start = time.monotonic()
+            results = chassis.set_all_fan_trays_speed(self.speed)
+            self.last_msecs = report_fan_action('fan.all.set_speed {}'.format(self.speed), results, start)
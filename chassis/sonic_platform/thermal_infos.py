@@ -1,3 +1,4 @@
+import time
 from sonic_platform_base.sonic_thermal_control.thermal_info_base import ThermalPolicyInfoBase
 from sonic_platform_base.sonic_thermal_control.thermal_json_object import thermal_json_object
 from sonic_py_common import daemon_base
@@ -51,9 +52,24 @@ class ThermalInfo(ThermalPolicyInfoBase):
     NOKIA_MAX_TEMP = 127.0
     NOKIA_MIN_TEMP = -128.0
 
+    # the mirror is rebuilt from the tables every RESYNC_CYCLES collections
+    RESYNC_CYCLES = 30
+    SLOW_COLLECT_MSECS = 1000
+
     def __init__(self):
         self.init = False
         self.lc_thermal_dict = {}
+        # one CHASSIS_STATE_DB connection for the life of the daemon and an
+        # in-memory mirror of the line cards' (fan) sensor rows, kept up to
+        # date by keyspace notifications: {slot: {key: fv_dict}}
+        self.chassis_state_db = None
+        self.sel = None
+        self.subscribers = {}
+        self.lc_fan_rows = {}
+        self.cycles = 0
+        self.collect_msecs = 0
+        self.collect_max_msecs = 0
+        self.collect_total_msecs = 0
 
     def init_extreme(self):
         self.curr_temp = self.NOKIA_INVALID_TEMP
@@ -69,6 +85,91 @@ class ThermalInfo(ThermalPolicyInfoBase):
         if (temp < self.min_temp) or (self.min_temp == self.NOKIA_INVALID_TEMP):
             self.min_temp = temp
 
+    def _reset_mirror(self):
+        self.sel = None
+        self.subscribers = {}
+        self.lc_fan_rows = {}
+
+    def _apply_updates(self, slot, updates):
+        rows = self.lc_fan_rows.setdefault(slot, {})
+        for key, op, fvs in updates:
+            # Skip temperature sensors not required for FAN reading.
+            if not key.endswith('(fan)'):
+                continue
+            if op == 'SET':
+                rows[key] = dict(fvs)
+            elif op == 'DEL':
+                rows.pop(key, None)
+
+    def _read_slot(self, slot):
+        # polling fallback when notifications are unavailable
+        lc_thermal_tbl = swsscommon.Table(self.chassis_state_db, 'TEMPERATURE_INFO_'+str(slot))
+        rows = {}
+        for key in lc_thermal_tbl.getKeys():
+            if not key.endswith('(fan)'):
+                continue
+            status, fvs = lc_thermal_tbl.get(key)
+            if status:
+                rows[key] = dict(fvs)
+        self.lc_fan_rows[slot] = rows
+
+    def _subscribe_slot(self, slot):
+        if self.sel is None:
+            self.sel = swsscommon.Select()
+        try:
+            subscriber = swsscommon.SubscriberStateTable(self.chassis_state_db, 'TEMPERATURE_INFO_'+str(slot))
+        except Exception as e:
+            logger.log_warning('TEMPERATURE_INFO_{} notifications unavailable, polling: {}'.format(slot, e))
+            self.subscribers[slot] = None
+            return
+        self.sel.addSelectable(subscriber)
+        self.subscribers[slot] = subscriber
+        # the subscriber starts with the table's current content
+        self._apply_updates(slot, subscriber.pops())
+
+    def _refresh_mirror(self, slots):
+        if self.chassis_state_db is None:
+            self.chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
+        if self.cycles % self.RESYNC_CYCLES == 0:
+            self._reset_mirror()
+
+        for slot in slots:
+            if slot not in self.subscribers:
+                self._subscribe_slot(slot)
+
+        if self.sel is not None:
+            # drain all pending notifications without blocking
+            for i in range(len(self.subscribers) * 16):
+                state, selectable = self.sel.select(0)
+                if state == swsscommon.Select.TIMEOUT:
+                    break
+                if state != swsscommon.Select.OBJECT:
+                    logger.log_warning('CHASSIS_STATE_DB select failed, resyncing thermal mirror')
+                    self._reset_mirror()
+                    for slot in slots:
+                        self._subscribe_slot(slot)
+                    break
+                for slot, subscriber in self.subscribers.items():
+                    if subscriber is not None:
+                        self._apply_updates(slot, subscriber.pops())
+
+        for slot in slots:
+            if self.subscribers.get(slot) is None:
+                self._read_slot(slot)
+
+    def _report_collect_time(self, start):
+        self.collect_msecs = int((time.monotonic() - start) * 1000)
+        self.collect_max_msecs = max(self.collect_max_msecs, self.collect_msecs)
+        self.collect_total_msecs += self.collect_msecs
+        self.cycles += 1
+        if self.collect_msecs >= self.SLOW_COLLECT_MSECS:
+            logger.log_warning('Line card thermal collection took {}ms'.format(self.collect_msecs))
+        else:
+            logger.log_debug('Line card thermal collection took {}ms'.format(self.collect_msecs))
+        if self.cycles % self.RESYNC_CYCLES == 0:
+            logger.log_info('Line card thermal collection: {} cycles avg {}ms max {}ms'.format(
+                self.cycles, self.collect_total_msecs // self.cycles, self.collect_max_msecs))
+
     def collect(self, chassis):
         """
         Collect thermal sensor temperature change status
@@ -80,33 +181,26 @@ class ThermalInfo(ThermalPolicyInfoBase):
         if chassis.get_supervisor_slot() != chassis.get_my_slot():
             return
 
-        chassis_state_db = daemon_base.db_connect("CHASSIS_STATE_DB")
+        start = time.monotonic()
+        slots = []
         for module_index in range(1, num_modules + 1):
             # if chassis.get_module(module_index - 1).get_status() is not 'Online':
             #    continue
             if chassis.get_module(module_index - 1).get_type() != ModuleBase.MODULE_TYPE_LINE:
                 continue
+            slots.append(chassis.get_module(module_index - 1)._get_hw_slot())
 
-            slot = chassis.get_module(module_index - 1)._get_hw_slot()
-            table_name = 'TEMPERATURE_INFO_'+str(slot)
-            lc_thermal_tbl = swsscommon.Table(chassis_state_db, table_name)
+        self._refresh_mirror(slots)
 
+        for slot in slots:
             # Find min, max, curr, margin temp for each module
             self.init_extreme()
 
-            # Walk the table and store in the dictionary
-            keys = lc_thermal_tbl.getKeys()
-            if not keys:
+            rows = self.lc_fan_rows.get(slot)
+            if not rows:
                 continue
 
-            for key in keys:
-                # Skip temperature sensors not required for FAN reading.
-                if not key.endswith('(fan)'):
-                    continue
-
-                status, fvs = lc_thermal_tbl.get(key)
-                fv_dict = dict(fvs)
-
+            for fv_dict in rows.values():
                 # For J2 temperatures, there is remote normalization
                 normalize = 0.0
                 if (float(fv_dict['high_threshold']) ==
@@ -127,6 +221,8 @@ class ThermalInfo(ThermalPolicyInfoBase):
 
             self.lc_thermal_dict[slot] = slot_avg_dict
 
+        self._report_collect_time(start)
+
 
 @thermal_json_object('chassis_info')
 class ChassisInfo(ThermalPolicyInfoBase):
@@ -1,6 +1,10 @@
 from __future__ import print_function
 
 try:
+    import glob
+    import json
+    import os
+    import time
     from sonic_platform_base.watchdog_base import WatchdogBase
     from sonic_py_common.logger import Logger
 
@@ -8,6 +12,18 @@ except ImportError as e:
     raise ImportError(str(e) + "- required module not found")
 logger = Logger("wdog")
 
+# The nokia_gpio_wdt device is held open and kicked by the nokia-watchdog
+# supervisor service, a watchdog device has a single opener. The platform
+# API drives it through the supervisor: arming writes a deadline to
+# NOKIA_WDT_ARM_FILE after which the kicks stop and the card reboots, the
+# kick statistics come from NOKIA_WDT_STATUS_FILE. Both use CLOCK_MONOTONIC
+# which is shared by the host and the containers.
+NOKIA_WDT_STATUS_FILE = '/var/run/redis/nokia-watchdog.json'
+NOKIA_WDT_ARM_FILE = '/var/run/redis/nokia-watchdog.arm'
+NOKIA_WDT_ERROR = -1
+# per-kick latency kept by the nokia_gpio_wdt driver
+NOKIA_WDT_SYSFS_GLOB = '/sys/class/watchdog/watchdog*/kick_stats'
+
 
 class Watchdog(WatchdogBase):
     _initialized = False
@@ -16,23 +32,108 @@ class Watchdog(WatchdogBase):
         # logger.set_min_log_priority_info()
         logger.log_info("Watchdog __init__{}".format(self))
 
+    def _read_json(self, path):
+        try:
+            with open(path, 'r') as f:
+                return json.load(f)
+        except (OSError, ValueError):
+            return None
+
+    def _supervisor_status(self):
+        """
+        Returns the supervisor's status if it is running and kicking,
+        None otherwise
+        """
+        status = self._read_json(NOKIA_WDT_STATUS_FILE)
+        if status is None:
+            return None
+        # updated every period, allow one late update
+        if time.monotonic() - status['updated'] > 2 * status['period'] + status['late_secs']:
+            return None
+        return status
+
+    def _arm_deadline(self):
+        arm = self._read_json(NOKIA_WDT_ARM_FILE)
+        if arm is None:
+            return None
+        return arm.get('deadline')
+
     def arm(self, seconds):
+        """
+        Stops the kicks seconds from now unless re-armed or disarmed. The
+        hardware expiry is fixed, the card reboots once it runs out after
+        the last kick.
+        """
+        logger.log_info("Watchdog arm {}".format(seconds))
+        if seconds < 0 or self._supervisor_status() is None:
+            return NOKIA_WDT_ERROR
+
+        arm = {'deadline': time.monotonic() + seconds, 'seconds': seconds, 'pid': os.getpid()}
+        try:
+            with open(NOKIA_WDT_ARM_FILE + '.tmp', 'w') as f:
+                json.dump(arm, f)
+            os.replace(NOKIA_WDT_ARM_FILE + '.tmp', NOKIA_WDT_ARM_FILE)
+        except OSError as e:
+            logger.log_error("Watchdog arm failed: {}".format(e))
+            return NOKIA_WDT_ERROR
         self._initialized = True
-        logger.log_info("Watchdog arm")
-        # hook this up to actual kicker shortly
         return seconds
 
     def disarm(self):
+        """
+        Cancels a pending arm, the supervisor keeps kicking
+        """
         logger.log_info("Watchdog disarm")
-        return False
+        try:
+            os.unlink(NOKIA_WDT_ARM_FILE)
+        except FileNotFoundError:
+            pass
+        except OSError as e:
+            logger.log_error("Watchdog disarm failed: {}".format(e))
+            return False
+        self._initialized = False
+        return self._supervisor_status() is not None
 
     def is_armed(self):
-        if self._initialized is True:
-            logger.log_info("Watchdog is_armed")
-            return True
-        else:
-            return False
+        return self._arm_deadline() is not None and self._supervisor_status() is not None
 
     def get_remaining_time(self):
-        logger.log_info("Watchdog get_remaining_time")
-        raise NotImplementedError
+        if not self.is_armed():
+            return NOKIA_WDT_ERROR
+        return max(0, int(self._arm_deadline() - time.monotonic()))
+
+    def _get_driver_kick_stats(self):
+        for path in glob.glob(NOKIA_WDT_SYSFS_GLOB):
+            try:
+                with open(path, 'r') as f:
+                    stats = dict((k, int(v)) for k, v in (line.split() for line in f if line.strip()))
+                with open(os.path.join(os.path.dirname(path), 'kick_method'), 'r') as f:
+                    stats['method'] = f.read().strip()
+            except (OSError, ValueError):
+                continue
+            return stats
+        return None
+
+    def get_kick_stats(self):
+        """
+        Retrieves the kick statistics of the watchdog supervisor
+        Returns:
+            A dict with running (supervisor kicking), kicks, missed_kicks,
+            last_kick_age and max_gap in seconds, late_kicks and period;
+            only running False if the supervisor is not running. driver
+            has the driver's kick method, count, failures and min/avg/max
+            latency in ns, or None.
+        """
+        status = self._supervisor_status()
+        if status is None:
+            return {'running': False, 'driver': self._get_driver_kick_stats()}
+        last_kick_age = None
+        if status['last_kick'] is not None:
+            last_kick_age = round(time.monotonic() - status['last_kick'], 3)
+        stats = {'running': True, 'kicks': status['kicks'], 'missed_kicks': status['missed_kicks'],
+                 'last_kick_age': last_kick_age, 'max_gap': status['max_gap'],
+                 'late_kicks': status['late_kicks'], 'period': status['period'],
+                 'driver': self._get_driver_kick_stats()}
+        if last_kick_age is not None and last_kick_age > status['period'] + status['late_secs']:
+            logger.log_warning("Watchdog kicker starved, last kick {}s ago".format(last_kick_age))
+        return stats
@@ -259,76 +259,59 @@ save_file() {
     end_t=$(date +%s%3N)
     echo "[ save_file:$orig_path] : $(($end_t-$start_t)) msec"  >> $TECHSUPPORT_TIME_INFO
 }
-save_ndk_general_info() {
-    echo "Capture NDK general info"
-    NDK_GENERAL=ndk.general.txt
-    save_tar_cmd "nokia_cmd show ndk-version"  "${NDK_GENERAL}"  
-    save_tar_cmd "nokia_cmd show ndk-status"   "${NDK_GENERAL}"
-    save_tar_cmd "nokia_cmd show platform"     "${NDK_GENERAL}"
+###############################################################################
+# Captures the nokia_cmd show sections with one concurrent 'nokia_cmd collect'
+# into $LOGDIR and appends the files to the tar.
+# Globals:
+#  LOGDIR
+#  BASE
+#  TARFILE
+#  DUMPDIR
+#  IS_SUP
+#  TIMEOUT_MIN
+#  NOOP
+# Returns:
+#  None
+###############################################################################
+save_ndk_sections() {
+    echo "Capture NDK sections"
+    local start_t=$(date +%s%3N)
+    local end_t=0
+    local sections="general,syseeprom,sensors,system-leds"
+    local cmd=""
+    local f=""
+
     if [ $IS_SUP -eq 1 ]; then
-        save_tar_cmd "nokia_cmd show power"    "${NDK_GENERAL}"
-    fi
-    save_tar_cmd "nokia_cmd show firmware"     "${NDK_GENERAL}" true
-}
-save_ndk_sensors_info() {
-    echo "Capture NDK sensors info"
-    NDK_SENSORS=ndk.sensors.txt
-    if [ $IS_SUP -eq 0 ]; then
-        save_tar_cmd "nokia_cmd show sensors"           "${NDK_SENSORS}"
-        save_tar_cmd "nokia_cmd show asic-temperature"  "${NDK_SENSORS}"  true
+        sections+=",power,ndk-eeprom,psus,midplane,sfm"
     else
-        save_tar_cmd "nokia_cmd show sensors"  "${NDK_SENSORS}" true
-    fi
-}
-save_ndk_psus_info() {
-    if [ $IS_SUP -eq 1 ]; then 
-        echo "Capture NDK PSUs info"
-        NDK_PSUS=ndk.psus.txt
-        save_tar_cmd "nokia_cmd show psus"  "${NDK_PSUS}" true
+        sections+=",asic-temperature,sfp,mdipc,qfpga"
     fi
-}
-save_ndk_system_leds_info() {
-    echo "Capture NDK system leds info"
-    NDK_SYSTEM_LEDS=ndk.system_leds.txt
-    save_tar_cmd "nokia_cmd show system-leds" "${NDK_SYSTEM_LEDS}" true
-}
-save_ndk_syseeprom_info() {
-    echo "Capture NDK syseeprom info"
-    NDK_SYSEEPROM=ndk.eeprom.txt
-    if [ $IS_SUP -eq 1 ]; then
-        save_tar_cmd "nokia_cmd show syseeprom"  "${NDK_SYSEEPROM}"
-        save_tar_cmd "nokia_cmd show ndk-eeprom" "${NDK_SYSEEPROM}" true
-    else
-        save_tar_cmd "nokia_cmd show syseeprom"  "${NDK_SYSEEPROM}" true
+    cmd="nokia_cmd collect --dir ${LOGDIR} --sections ${sections} --timeout $((${TIMEOUT_MIN} * 60))"
+
+    [ ! -d $LOGDIR ] && $MKDIR $V -p $LOGDIR
+    if $NOOP; then
+        echo "$cmd >> $TECHSUPPORT_TIME_INFO"
+        return
     fi
-}
-save_ndk_midplane_info() {
-    if [ $IS_SUP -eq 1 ]; then
-        echo "Capture midplane info"
-        NDK_MIDPLANE=ndk.midplane.txt
-        save_tar_cmd "nokia_cmd show midplane port-status"    "${NDK_MIDPLANE}"
-        save_tar_cmd "nokia_cmd show midplane port-counters"  "${NDK_MIDPLANE}"
-        save_tar_cmd "nokia_cmd show midplane vlan-table"     "${NDK_MIDPLANE}"
-        save_tar_cmd "nokia_cmd show midplane mac-table"      "${NDK_MIDPLANE}"
-        save_tar_cmd "nokia_cmd show midplane link-status-flap" "${NDK_MIDPLANE}"
-        save_tar_cmd "sudo ethtool xe0"    "${NDK_MIDPLANE}"
-        save_tar_cmd "sudo ethtool mgmt1"  "${NDK_MIDPLANE}" true
+    # collect kills its own sections on timeout, this only guards collect itself
+    timeout --foreground $((${TIMEOUT_MIN} + 1))m $cmd >> $TECHSUPPORT_TIME_INFO 2>&1
+    if [ $? -ne 0 ]; then
+        echo "Command: $cmd failed or timedout."
     fi
-}
-save_ndk_sfm_info() {
+
     if [ $IS_SUP -eq 1 ]; then
-        echo "Capture NDK SFMs info"
-        NDK_SFM=ndk.sfm.txt
-        save_tar_cmd "nokia_cmd show sfm-summary"  "${NDK_SFM}"
-        save_tar_cmd "nokia_cmd show sfm-eeprom"   "${NDK_SFM}" true
-    fi
-}
-save_ndk_sfp_info() {
-    if [ $IS_SUP -eq 0 ]; then
-        echo "Capture SFPs info"
-        NDK_SFP=ndk.sfp.txt
-        save_tar_cmd "nokia_cmd show fp-status"  "${NDK_SFP}" true
+        save_tar_cmd "sudo ethtool xe0"    "ndk.midplane.txt"
+        save_tar_cmd "sudo ethtool mgmt1"  "ndk.midplane.txt" true
     fi
+
+    for f in $LOGDIR/ndk.* $LOGDIR/qfpgamgr.*; do
+        [ -f "$f" ] || continue
+        ($TAR $V -rhf $TARFILE -C $DUMPDIR "${BASE}/dump/$(basename $f)" \
+            || abort "${ERROR_PROCFS_SAVE_FAILED}" "tar append operation failed. Aborting to prevent data loss.") \
+            && $RM $V -f "$f"
+    done
+    end_t=$(date +%s%3N)
+    echo "[ save_ndk_sections:$sections ] : $(($end_t-$start_t)) msec" >> $TECHSUPPORT_TIME_INFO
 }
 save_ndk_kernel_intf_info() {
     echo "Capture Kernel Intfs"
@@ -355,18 +338,6 @@ save_ndk_devicemgr_info() {
     save_file /tmp/$NDK_ADMINTECH* dump false true
     rm -f /tmp/$NDK_ADMINTECH*
 }
-save_ndk_qfpgamgr_info() {
-    if [ $IS_SUP -eq 0 ]; then
-        echo "Capture ndk qfpgamgr info"
-        # Admintech
-        NDK_ADMINTECH=qfpgamgr.admintech.txt
-        save_tar_cmd "nokia_cmd show qfpga version"         "${NDK_ADMINTECH}"
-        save_tar_cmd "nokia_cmd show qfpga port-status"     "${NDK_ADMINTECH}"
-        save_tar_cmd "nokia_cmd show qfpga vlan-counters"   "${NDK_ADMINTECH}"
-        save_tar_cmd "nokia_cmd show qfpga port-statistics" "${NDK_ADMINTECH}"
-        save_tar_cmd "nokia_cmd show qfpga error-counters"  "${NDK_ADMINTECH}" true
-    fi
-}
 save_syslog_file() {
     echo "Copy syslog file"
     log_dir=log
@@ -413,19 +384,11 @@ main() {
         IS_SUP=0
     fi
     
-    save_ndk_general_info
-    save_ndk_syseeprom_info
-    save_ndk_sensors_info    
-    save_ndk_psus_info
-    save_ndk_system_leds_info
-    save_ndk_sfp_info
-    save_ndk_midplane_info
-    save_ndk_sfm_info
+    save_ndk_sections
     save_ndk_kernel_intf_info
     save_platform_info
     save_file /usr/share/sonic/device/${onie_platform}/platform_ndk.json dump false true
     save_ndk_devicemgr_info
-    save_ndk_qfpgamgr_info
     save_ndk_cores
     save_syslog_file
     
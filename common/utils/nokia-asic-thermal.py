@@ -30,6 +30,13 @@ ASIC_SENSOR_POLL_STATUS = 'ASIC_SENSORS_POLLER_STATUS'
 ASIC_SENSOR_ADMIN_STATE = 'admin_status'
 ASIC_SENSOR_INTERVAL = 'interval'
 ASIC_TEMP_DEVICE_THRESHOLD = 102
+ASIC_TEMP_TABLE = 'ASIC_TEMPERATURE_INFO'
+# push only when a temp-device moved by at least this many degrees, or to
+# refresh the NDK every ASIC_TEMP_REFRESH_SECS
+ASIC_TEMP_HYSTERESIS = 1
+ASIC_TEMP_REFRESH_SECS = 300
+# a sensor poll writes several fields, wait for them to settle
+ASIC_TEMP_SETTLE_SECS = 0.5
 temp_mon_list = ['FAB0', 'FAB1', 'FAB2', 'FAB3', 'NIF0', 'NIF1', 'PRM', 'EMI0', 'EMI1' ]
 
 
@@ -42,6 +49,9 @@ class asic_thermal(object):
      self.config_db_keys = {}
      self.state_db_keys = {}
      self.poll_interval = {}
+     self.subscribers = {}
+     self.pushed = {}
+     self.push_time = 0
 
      if multi_asic.is_multi_asic():
        # Load the namespace details first from the database_global.json file.
@@ -57,6 +67,18 @@ class asic_thermal(object):
         self.config_db[asic_id].connect()
 
         self.poll_interval[asic_id] = ASIC_SENSOR_DEFAULT_POLL_INTERVAL
+
+        # wake on STATE_DB keyspace notifications, fall back to polling
+        try:
+          # unix socket like the connectors above: a tcp connection from the
+          # host netns reaches the host redis instead of the namespace's
+          state_db = swsscommon.DBConnector("STATE_DB", 0, False, namespace)
+          subscriber = swsscommon.SubscriberStateTable(state_db, ASIC_TEMP_TABLE)
+          sel.addSelectable(subscriber)
+          self.subscribers[asic_id] = subscriber
+        except Exception as e:
+          print('ASIC{} temperature notifications unavailable, polling: {}'.format(asic_id, e))
+     self.sel = sel
      return
 
   def get_platform_and_hwsku(self):
@@ -107,23 +129,25 @@ class asic_thermal(object):
     nokia_cmd.print_table(field, item_list)
     return
 
-  def update_temperature(self, asic_id, asic_temp_data):
+  def get_temperature_devices(self, asic_id, asic_temp_data, devices):
     for key, value in asic_temp_data.items():
        if (int(value)) == 0:
+         # asic sensors not read yet
          return
+    for key, value in asic_temp_data.items():
        temp,index = key.split('_')
-       asic_temp = ''
        if temp == 'temperature':
          temp_name = 'ASIC' + str(asic_id) +'_' + index + '--' + temp_mon_list[int(index)]
        elif temp == 'average':
          temp_name = 'ASIC' + str(asic_id) + '_' + 'average'
        elif temp == 'maximum':
          temp_name = 'ASIC' + str(asic_id) +'_' + 'maximum'
-
-       nokia_cmd.set_asic_temp(temp_name, int(value), ASIC_TEMP_DEVICE_THRESHOLD)
+       else:
+         continue
+       devices[temp_name] = int(value)
     return
 
-  def get_db_asic_temp(self, namespace, asic_id):
+  def get_db_asic_temp(self, namespace, asic_id, devices):
     is_enabled = self.get_asic_sensor_config(asic_id)
     if is_enabled == True:
       self.state_db_keys[asic_id] = self.db[asic_id].keys(self.db[asic_id].STATE_DB, ASIC_TEMP_INFO)
@@ -132,25 +156,59 @@ class asic_thermal(object):
       #Get the ASIC Temperature from state_db
       for state_key in natsorted(self.state_db_keys[asic_id]):
          asic_temp_data = self.db[asic_id].get_all(self.db[asic_id].STATE_DB, state_key)
-         # Update NDK
-         self.update_temperature(asic_id, asic_temp_data)
+         self.get_temperature_devices(asic_id, asic_temp_data, devices)
+
+    return
+
+  def temperature_changed(self, devices):
+    if set(devices) != set(self.pushed):
+      return True
+    for name, temp in devices.items():
+      if abs(temp - self.pushed[name]) >= ASIC_TEMP_HYSTERESIS:
+        return True
+    return (time.monotonic() - self.push_time) >= ASIC_TEMP_REFRESH_SECS
+
+  def update_temperature(self, devices):
+    # Update NDK, all asics with one request
+    if not devices or not self.temperature_changed(devices):
+      return
+    temp_devices = [(name, devices[name], ASIC_TEMP_DEVICE_THRESHOLD) for name in natsorted(devices)]
+    if nokia_cmd.set_asic_temps(temp_devices):
+      self.pushed = devices
+      self.push_time = time.monotonic()
+    return
 
+  def wait_for_update(self, timeout):
+    if not self.subscribers:
+      time.sleep(timeout)
+      return
+    state, selectable = self.sel.select(int(timeout * 1000))
+    if state != swsscommon.Select.OBJECT:
+      return
+    time.sleep(ASIC_TEMP_SETTLE_SECS)
+    # drain, the tables are re-read as a whole
+    for subscriber in self.subscribers.values():
+      subscriber.pops()
     return
 
   def update_asic_temperature(self):
     namespaces = thermal.get_asic_namespaces()
     while True:
       timer_interval  = 0
+      devices = {}
       for namespace in namespaces:
         asic_id = multi_asic.get_asic_index_from_namespace(namespace)
-        thermal.get_db_asic_temp(namespace, asic_id)
+        thermal.get_db_asic_temp(namespace, asic_id, devices)
         interval = thermal.get_asic_poll_interval(asic_id)
         if interval != 0 and  timer_interval == 0:
            timer_interval = int(interval)
         if interval != 0 and  timer_interval > int(interval):
            timer_interval = int(interval)
-      #sleep for lowest polling interval of asics
-      time.sleep(timer_interval)
+      thermal.update_temperature(devices)
+      if timer_interval == 0:
+        timer_interval = ASIC_SENSOR_DEFAULT_POLL_INTERVAL
+      #wait for a STATE_DB update, at most the lowest polling interval of asics
+      thermal.wait_for_update(timer_interval)
     return
 
 if __name__ == "__main__":
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+#
+# Name: nokia-boot-profile.py, version: 1.0
+#
+# Description: Builds the boot timeline of the current boot from the
+# events written by the platform init scripts and daemons (see
+# nokia-boot-profile.sh) and the start-up timestamps of the platform
+# systemd services, e.g.
+#
+#   touch /etc/sonic/nokia_boot_profile; reboot
+#   nokia-boot-profile.py
+#   nokia-boot-profile.py --json > boot.json
+#
+# Event times are CLOCK_BOOTTIME seconds. systemd's *TimestampMonotonic
+# are CLOCK_MONOTONIC and are shifted by the time spent suspended, which
+# is exact unless the box was suspended after the services started.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+NOKIA_BOOT_PROFILE_FLAG = '/etc/sonic/nokia_boot_profile'
+NOKIA_BOOT_PROFILE_LOG = '/var/log/nokia-boot-profile.jsonl'
+
+# platform services in rough start order, pmon last as it is what makes
+# the platform visible to the rest of SONiC
+BOOT_PROFILE_UNITS = ['ixr7220h3_platform_init.service', 'h4_32d_platform_init.service',
+                      'h5_64d_platform_init.service', 'nokia-watchdog.service',
+                      'nokia-sr-device-mgr.service', 'nokia-ndk-qfpga-mgr.service',
+                      'nokia-eth-mgr.service', 'nokia-phy-mgr.service',
+                      'nokia-asic-thermal.service', 'pmon.service']
+READY_UNIT = 'pmon.service'
+
+UNIT_PROPERTIES = ['Id', 'InactiveExitTimestampMonotonic', 'ExecMainStartTimestampMonotonic',
+                   'ActiveEnterTimestampMonotonic']
+
+
+def boot_id():
+    with open('/proc/sys/kernel/random/boot_id') as f:
+        return f.read().strip()
+
+
+def boot_profile_enabled():
+    if os.path.exists(NOKIA_BOOT_PROFILE_FLAG):
+        return True
+    try:
+        with open('/proc/cmdline') as f:
+            return 'nokia_boot_profile=1' in f.read().split()
+    except OSError:
+        return False
+
+
+def read_events(path, current):
+    events = []
+    try:
+        with open(path) as f:
+            for line in f:
+                try:
+                    ev = json.loads(line)
+                except ValueError:
+                    continue
+                if ev.get('boot_id') == current:
+                    events.append(ev)
+    except OSError:
+        pass
+    return sorted(events, key=lambda e: e['t'])
+
+
+def pair_phases(events):
+    phases = []
+    open_phases = {}
+    for ev in events:
+        key = (ev['src'], ev['phase'], ev['detail'])
+        if ev['ev'] == 'begin':
+            open_phases[key] = ev['t']
+        elif ev['ev'] == 'end' and key in open_phases:
+            start = open_phases.pop(key)
+            phases.append({'src': ev['src'], 'phase': ev['phase'], 'detail': ev['detail'],
+                           'start': start, 'end': ev['t'], 'secs': round(ev['t'] - start, 3)})
+    for (src, phase, detail), start in open_phases.items():
+        phases.append({'src': src, 'phase': phase, 'detail': detail,
+                       'start': start, 'end': None, 'secs': None})
+    return sorted(phases, key=lambda p: p['start'])
+
+
+def suspended_secs():
+    # CLOCK_BOOTTIME - CLOCK_MONOTONIC
+    return max(time.clock_gettime(time.CLOCK_BOOTTIME) - time.clock_gettime(time.CLOCK_MONOTONIC), 0.0)
+
+
+def read_units(units):
+    cmd = ['systemctl', 'show', '-p', ','.join(UNIT_PROPERTIES)] + units
+    try:
+        out = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                             universal_newlines=True).stdout
+    except OSError:
+        return []
+    offset = suspended_secs()
+    result = []
+    for block in out.strip().split('\n\n'):
+        props = dict(line.split('=', 1) for line in block.splitlines() if '=' in line)
+        start = int(props.get('InactiveExitTimestampMonotonic') or 0)
+        active = int(props.get('ActiveEnterTimestampMonotonic') or 0)
+        if not start:
+            continue
+        result.append({'unit': props.get('Id'), 'start': start / 1000000.0 + offset,
+                       'active': active / 1000000.0 + offset if active else None,
+                       'secs': round((active - start) / 1000000.0, 3) if active else None})
+    return sorted(result, key=lambda u: u['start'])
+
+
+def build_timeline(path, units):
+    current = boot_id()
+    events = read_events(path, current)
+    unit_info = read_units(units)
+    ready = [u['active'] for u in unit_info if u['unit'] == READY_UNIT and u['active']]
+    return {'boot_id': current,
+            'time_to_ready': ready[0] if ready else None,
+            'units': unit_info,
+            'phases': pair_phases(events),
+            'marks': [e for e in events if e['ev'] == 'mark']}
+
+
+def print_timeline(timeline):
+    def secs(val):
+        return '-' if val is None else '{:.3f}'.format(val)
+
+    print('boot {}  time to ready ({}): {}s'.format(timeline['boot_id'], READY_UNIT,
+                                                   secs(timeline['time_to_ready'])))
+    rows = []
+    for u in timeline['units']:
+        rows.append((u['start'], u['unit'], '', u['secs']))
+    for p in timeline['phases']:
+        rows.append((p['start'], p['src'], p['phase'] + (' ' + p['detail'] if p['detail'] else ''), p['secs']))
+    for m in timeline['marks']:
+        rows.append((m['t'], m['src'], '* ' + m['phase'] + (' ' + m['detail'] if m['detail'] else ''), None))
+    print('{:>10}  {:>8}  {:<30} {}'.format('t(s)', 'secs', 'source', 'phase'))
+    for t, src, phase, duration in sorted(rows, key=lambda r: r[0]):
+        print('{:>10}  {:>8}  {:<30} {}'.format(secs(t), secs(duration), src, phase))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Nokia platform boot timeline')
+    parser.add_argument('--json', action='store_true', help='machine readable output')
+    parser.add_argument('--log', default=NOKIA_BOOT_PROFILE_LOG, help='event file')
+    parser.add_argument('--units', nargs='+', default=BOOT_PROFILE_UNITS, help='systemd units to include')
+    args = parser.parse_args()
+
+    if not boot_profile_enabled():
+        sys.stderr.write('boot profiling is off, touch {} and reboot\n'.format(NOKIA_BOOT_PROFILE_FLAG))
+
+    timeline = build_timeline(args.log, args.units)
+    if args.json:
+        print(json.dumps(timeline, indent=2))
+    else:
+        print_timeline(timeline)
+
+
+if __name__ == '__main__':
+    main()
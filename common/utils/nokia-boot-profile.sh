@@ -0,0 +1,73 @@
+#!/bin/bash
+#
+# Name: nokia-boot-profile.sh, version: 1.0
+#
+# Description: Boot-time profiling helpers sourced by the platform init
+# scripts. Profiling is off unless /etc/sonic/nokia_boot_profile exists or
+# nokia_boot_profile=1 is on the kernel command line. When on, every call
+# appends one JSON line to /var/log/nokia-boot-profile.jsonl:
+#
+#   {"boot_id": "...", "t": 12.34, "src": "h4_32d_platform_init", "ev": "begin", "phase": "module_load", "detail": ""}
+#
+# t is seconds since boot from /proc/uptime, i.e. CLOCK_BOOTTIME, the clock
+# of every source of the file. nokia-boot-profile.py moves the systemd
+# service start times (*Monotonic, CLOCK_MONOTONIC) onto it and merges
+# them into one timeline. When off the helpers return
+# without forking so the init scripts pay nothing.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+NOKIA_BOOT_PROFILE_FLAG=/etc/sonic/nokia_boot_profile
+NOKIA_BOOT_PROFILE_LOG=/var/log/nokia-boot-profile.jsonl
+
+boot_prof_src=${0##*/}
+boot_prof_src=${boot_prof_src%.sh}
+boot_prof_on=0
+read -r boot_prof_cmdline < /proc/cmdline
+if [ -e $NOKIA_BOOT_PROFILE_FLAG ] || [[ " $boot_prof_cmdline " == *" nokia_boot_profile=1 "* ]]; then
+    boot_prof_on=1
+    read -r boot_prof_id < /proc/sys/kernel/random/boot_id
+fi
+
+# boot_prof_event <ev> <phase> [detail]
+boot_prof_event() {
+    [ $boot_prof_on -eq 1 ] || return 0
+    local up idle
+    read -r up idle < /proc/uptime
+    printf '{"boot_id": "%s", "t": %s, "src": "%s", "ev": "%s", "phase": "%s", "detail": "%s"}\n' \
+        "$boot_prof_id" "$up" "$boot_prof_src" "$1" "$2" "$3" >> $NOKIA_BOOT_PROFILE_LOG
+}
+
+boot_prof_begin() {
+    boot_prof_event begin "$1" "$2"
+}
+
+boot_prof_end() {
+    boot_prof_event end "$1" "$2"
+}
+
+boot_prof_mark() {
+    boot_prof_event mark "$1" "$2"
+}
+
+# boot_prof_first_read <phase> <sysfs glob> [timeout secs]
+# Marks the first successful read of a sensor attribute. Polls in the
+# foreground as a oneshot service's leftover processes are killed when it
+# exits; call it last so the phases before it are not skewed.
+boot_prof_first_read() {
+    [ $boot_prof_on -eq 1 ] || return 0
+    local phase=$1 pattern=$2 timeout=${3:-10}
+    local i f val
+    for ((i = 0; i < timeout * 10; i++)); do
+        for f in $pattern; do
+            if [ -r "$f" ] && read -r val < "$f" 2>/dev/null && [ -n "$val" ]; then
+                boot_prof_mark "$phase" "$f=$val"
+                return 0
+            fi
+        done
+        sleep 0.1
+    done
+    boot_prof_mark "$phase" "timeout"
+}
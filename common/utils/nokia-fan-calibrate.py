@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#
+# Name: nokia-fan-calibrate.py, version: 1.0
+#
+# Description: Measures the PWM-to-RPM curve of every fan of a 7220
+# platform and stores it in /etc/sonic/nokia_fan_calibration.json, from
+# where the platform's Fan class uses it. thermalctld is stopped in pmon
+# for the sweep and restarted afterwards. One drawer is swept at a time
+# with the others at full speed; the sweep is aborted, leaving every fan
+# at full speed, if a thermal goes above its high threshold. Run again
+# after replacing a fan drawer, a drawer with another serial number is
+# not calibrated, e.g.
+#
+#   nokia-fan-calibrate.py
+#   nokia-fan-calibrate.py --show
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import argparse
+import json
+import subprocess
+import sys
+
+THERMALCTLD_CMD = ['docker', 'exec', 'pmon', 'supervisorctl']
+
+
+def thermalctld(action):
+    try:
+        out = subprocess.run(THERMALCTLD_CMD + [action, 'thermalctld'], capture_output=True,
+                             text=True, timeout=60)
+        return out.stdout.strip()
+    except (OSError, subprocess.SubprocessError) as e:
+        return str(e)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Nokia 7220 fan PWM-to-RPM calibration')
+    parser.add_argument('--show', action='store_true', help='print the stored calibration')
+    parser.add_argument('--settle', type=float, default=None, help='seconds to settle at each PWM step')
+    args = parser.parse_args()
+
+    from sonic_platform import fan as platform_fan
+    if args.show:
+        print(json.dumps(platform_fan.load_calibration(), indent=2))
+        return 0
+
+    from sonic_platform.chassis import Chassis
+    chassis = Chassis()
+    fans = chassis.get_all_fans()
+    drawers = set(fan.fan_drawer for fan in fans if not fan.is_psu_fan)
+
+    was_running = 'RUNNING' in thermalctld('status')
+    if was_running:
+        print(thermalctld('stop'))
+    try:
+        settle = args.settle if args.settle is not None else platform_fan.FAN_CALIBRATION_SETTLE_SECS
+        print('Sweeping {} fans in {} drawers, about {}s'.format(
+            len(fans), len(drawers), int(len(drawers) * len(platform_fan.FAN_CALIBRATION_PWM) * (settle + 1.5))))
+        calibration = platform_fan.calibrate_fans(fans, settle, chassis.get_all_thermals())
+    except platform_fan.FanCalibrationAborted as e:
+        print('Calibration aborted, fans left at full speed: {}'.format(e))
+        return 1
+    finally:
+        if was_running:
+            print(thermalctld('start'))
+
+    for name in sorted(calibration, key=lambda n: int(n[len('Fan'):])):
+        points = ' '.join('{}:{}'.format(pwm, rpm) for pwm, rpm in calibration[name]['points'])
+        print('{:6} {:>6} rpm  {}'.format(name, calibration[name]['max_rpm'], points))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
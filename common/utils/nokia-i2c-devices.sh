@@ -0,0 +1,143 @@
+#!/bin/bash
+#
+# Name: nokia-i2c-devices.sh, version: 1.0
+#
+# Description: I2C client instantiation helpers sourced by the platform
+# init scripts.
+#
+# Mux channel buses get their numbers in registration order and the
+# platform code uses fixed bus numbers, so muxes are created one at a time
+# by i2c_new_mux, in the order of the calls, each waiting until all of its
+# channels are registered. The first channel's bus number can be checked
+# against the one the platform code expects.
+#
+# Leaf devices (eeproms, sensors, CPLDs ...) do not add buses. They are
+# queued per parent bus with i2c_new_device and created by
+# i2c_instantiate_devices, one writer per bus, all buses at once. Each
+# device waits for its directory and driver bind, so no fixed sleeps are
+# needed. Devices that do not bind within I2C_READY_TIMEOUT seconds are
+# reported.
+#
+#   i2c_new_mux i2c-0 pca9548 0x70 2 || failed=$((failed + 1))
+#   i2c_new_device 4-0075/channel-0 24c02 0x50
+#   i2c_instantiate_devices || echo "$? i2c devices failed"
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+I2C_DEVICES_PATH=/sys/bus/i2c/devices
+I2C_READY_TIMEOUT=${I2C_READY_TIMEOUT:-5}
+
+declare -A i2c_queue
+
+# i2c_mux_channels <driver>
+i2c_mux_channels() {
+    case $1 in
+        pca9548|pca9547) echo 8 ;;
+        pca9546|pca9545|pca9544) echo 4 ;;
+        *) echo 2 ;;
+    esac
+}
+
+# i2c_new_mux <parent bus> <driver> <addr> [first channel bus]: creates the
+# mux now and waits for its channels, returns 1 if it did not come up or
+# its first channel is not bus number <first channel bus>
+i2c_new_mux() {
+    local parent=$1 driver=$2 addr=$3 expected=$4
+    local path=$I2C_DEVICES_PATH/$1 real bus dev last first
+
+    i2c_prof begin new_mux "$parent $driver $addr"
+    if ! i2c_wait_path "$path/new_device"; then
+        echo "i2c: bus $parent not present for $driver $addr" >&2
+        i2c_prof mark bind_failed "$parent $driver $addr"
+        return 1
+    fi
+    real=$(cd -P "$path" && pwd)
+    bus=${real##*/i2c-}
+    dev=$I2C_DEVICES_PATH/$(printf '%d-%04x' "$bus" "$addr")
+    last=$(($(i2c_mux_channels "$driver") - 1))
+    [ -e "$dev" ] || echo "$driver $addr" > "$path/new_device"
+    if ! i2c_wait_path "$dev/channel-$last"; then
+        echo "i2c: mux $driver $addr on $parent (${dev##*/}) channels not registered" >&2
+        i2c_prof mark bind_failed "$parent $driver $addr"
+        return 1
+    fi
+    first=$(readlink "$dev/channel-0")
+    first=${first##*i2c-}
+    i2c_prof end new_mux "$parent $driver $addr"
+    echo "i2c: mux ${dev##*/} channels i2c-$first..$((first + last))"
+    if [ -n "$expected" ] && [ "$first" != "$expected" ]; then
+        echo "i2c: mux ${dev##*/} channel-0 is i2c-$first, expected i2c-$expected" >&2
+        return 1
+    fi
+    return 0
+}
+
+# i2c_new_device <parent bus> <driver> <addr>: queues a leaf device
+i2c_new_device() {
+    i2c_queue[$1]+="$2 $3"$'\n'
+}
+
+# i2c_wait_path <path> <what>, 10 ms polls up to I2C_READY_TIMEOUT
+i2c_wait_path() {
+    local i
+    for ((i = 0; i < I2C_READY_TIMEOUT * 100; i++)); do
+        [ -e "$1" ] && return 0
+        sleep 0.01
+    done
+    return 1
+}
+
+i2c_prof() {
+    [ "$(type -t boot_prof_event)" = "function" ] && boot_prof_event "$@"
+    return 0
+}
+
+# i2c_bus_writer <parent bus>: creates the bus' queued leaf devices in order,
+# returns the number that failed to bind
+i2c_bus_writer() {
+    local parent=$1 path=$I2C_DEVICES_PATH/$1 failed=0
+    local real bus driver addr dev
+
+    i2c_prof begin new_device "$parent"
+    if ! i2c_wait_path "$path/new_device"; then
+        echo "i2c: bus $parent not present" >&2
+        i2c_prof mark bind_failed "$parent"
+        return 1
+    fi
+    real=$(cd -P "$path" && pwd)
+    bus=${real##*/i2c-}
+
+    while read -r driver addr; do
+        [ -n "$driver" ] || continue
+        dev=$I2C_DEVICES_PATH/$(printf '%d-%04x' "$bus" "$addr")
+        # already created (e.g. by ACPI or a previous run) is fine
+        [ -e "$dev" ] || echo "$driver $addr" > "$path/new_device"
+        if ! i2c_wait_path "$dev/driver"; then
+            echo "i2c: $driver $addr on $parent (${dev##*/}) not bound" >&2
+            i2c_prof mark bind_failed "$parent $driver $addr"
+            ((failed++))
+        fi
+    done <<< "${i2c_queue[$parent]}"
+    i2c_prof end new_device "$parent"
+    return $failed
+}
+
+# i2c_instantiate_devices: creates the leaf devices queued so far, returns
+# the number of devices that failed to bind
+i2c_instantiate_devices() {
+    local parent failed=0
+    local -A pids
+
+    for parent in "${!i2c_queue[@]}"; do
+        i2c_bus_writer "$parent" &
+        pids[$parent]=$!
+    done
+    for parent in "${!pids[@]}"; do
+        wait ${pids[$parent]}
+        ((failed += $?))
+    done
+    i2c_queue=()
+    return $failed
+}
@@ -0,0 +1,508 @@
+#!/usr/bin/env python3
+#
+# Name: nokia-watchdog.py, version: 1.0
+#
+# Description: Hardware watchdog supervisor for Nokia platforms. Keeps
+# /dev/watchdog open and kicks it on a fixed monotonic schedule. The
+# platform NDK health check runs with a deadline shorter than the kick
+# period, so a slow check never delays a kick. A health worker forked at
+# start-up keeps the check's imports warm and forks a fresh child for every
+# check, so nothing the check creates outlives it. After
+# MIN_APP_COUNT_FAILURES failed checks in a row the kicks stop and the
+# watchdog reboots the card. Talks to systemd through sd_notify (READY,
+# WATCHDOG, STATUS) and keeps kick jitter and health check latency
+# statistics in the watchdog log.
+#
+# The platform API (sonic_platform/watchdog.py) reads the kick statistics
+# from WD_STATUS_FILE and arms the watchdog through WD_ARM_FILE: once the
+# deadline written there passes the kicks stop and the card reboots.
+# Removing the file disarms.
+#
+# Copyright (c) 2026, Nokia
+# All rights reserved.
+#
+
+import ast
+import ctypes
+import glob
+import json
+import os
+import runpy
+import select
+import signal
+import socket
+import subprocess
+import sys
+import time
+
+WATCHDOG_DEV = '/dev/watchdog'
+WATCHDOG_MODULE = 'nokia_gpio_wdt'
+WATCHDOG_KICK_SECS = 30
+# kicks sent before the health check is enforced
+WATCHDOG_SKIP_HM_KICKS = 2
+# a kick more than this late on the previous one is counted as late
+WATCHDOG_LATE_SECS = 5
+
+# shared with the platform API, /var/run/redis is also mounted in pmon
+WD_STATUS_FILE = '/var/run/redis/nokia-watchdog.json'
+WD_ARM_FILE = '/var/run/redis/nokia-watchdog.arm'
+
+HEALTH_CHECK = '/opt/srlinux/bin/platform_ndk_health_check.py'
+HEALTH_CHECK_DEADLINE_SECS = 20
+MIN_APP_COUNT_FAILURES = 3
+
+MACHINE_CONF = '/host/machine.conf'
+PLATFORM_NDK_JSON = '/usr/share/sonic/device/{}/platform_ndk.json'
+
+NOKIA_BOOT_PROFILE_FLAG = '/etc/sonic/nokia_boot_profile'
+NOKIA_BOOT_PROFILE_LOG = '/var/log/nokia-boot-profile.jsonl'
+
+LOG_DIR = '/var/log/'
+WD_INIT_LOG = LOG_DIR + 'nokia-watchdog-init.log'
+WD_LOG = LOG_DIR + 'nokia-watchdog.log'
+MAX_RETAINED_LOGS = 10
+
+# jitter histogram bucket upper bounds in msecs, plus one overflow bucket
+JITTER_BOUNDS_MS = (1, 5, 10, 50, 100, 500, 1000, 5000)
+
+
+def utc_date():
+    return time.strftime('%a %b %d %H:%M:%S UTC %Y', time.gmtime())
+
+
+class LatencyStats():
+    def __init__(self, bounds):
+        self.bounds = bounds
+        self.buckets = [0] * (len(bounds) + 1)
+        self.count = 0
+        self.total = 0.0
+        self.max = 0.0
+        self.last = 0.0
+
+    def record(self, msecs):
+        i = 0
+        while i < len(self.bounds) and msecs > self.bounds[i]:
+            i += 1
+        self.buckets[i] += 1
+        self.count += 1
+        self.total += msecs
+        self.last = msecs
+        self.max = max(self.max, msecs)
+
+    def percentile(self, pct):
+        target = self.count * pct / 100.0
+        seen = 0
+        for i, n in enumerate(self.buckets):
+            seen += n
+            if seen >= target and n:
+                return self.bounds[i] if i < len(self.bounds) else self.max
+        return 0
+
+    def __str__(self):
+        if self.count == 0:
+            return 'count 0'
+        return 'count {} last {:.1f}ms avg {:.1f}ms p99 <={}ms max {:.1f}ms'.format(
+            self.count, self.last, self.total / self.count, self.percentile(99), self.max)
+
+
+class SystemdNotifier():
+    def __init__(self):
+        self.sock = None
+        addr = os.environ.get('NOTIFY_SOCKET')
+        if not addr:
+            return
+        if addr.startswith('@'):
+            addr = '\0' + addr[1:]
+        try:
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_DGRAM | socket.SOCK_CLOEXEC)
+            self.sock.connect(addr)
+        except OSError:
+            self.sock = None
+
+    def notify(self, state):
+        if self.sock is None:
+            return
+        try:
+            self.sock.send(state.encode())
+        except OSError:
+            pass
+
+
+def boot_prof_event(ev, phase, detail=''):
+    """
+    Same record as boot_prof_event in nokia-boot-profile.sh
+    """
+    try:
+        if not os.path.exists(NOKIA_BOOT_PROFILE_FLAG):
+            with open('/proc/cmdline') as f:
+                if 'nokia_boot_profile=1' not in f.read().split():
+                    return
+        with open('/proc/sys/kernel/random/boot_id') as f:
+            boot_id = f.read().strip()
+        record = {'boot_id': boot_id, 't': round(time.clock_gettime(time.CLOCK_BOOTTIME), 3), 'src': 'nokia-watchdog',
+                  'ev': ev, 'phase': phase, 'detail': detail}
+        with open(NOKIA_BOOT_PROFILE_LOG, 'a') as f:
+            f.write(json.dumps(record) + '\n')
+    except OSError:
+        pass
+
+
+def rotate_logs():
+    for name in ('nokia-watchdog-init', 'nokia-watchdog-last', 'nokia-watchdog'):
+        logs = sorted(glob.glob(LOG_DIR + name + '*.log'), key=os.path.getmtime, reverse=True)
+        logs = [f for f in logs if os.path.basename(f)[len(name):-len('.log')].isdigit() or
+                os.path.basename(f) == name + '.log']
+        staged = []
+        for n, path in enumerate(logs, 1):
+            if n > MAX_RETAINED_LOGS:
+                os.unlink(path)
+            else:
+                os.replace(path, path + '.rotate')
+                staged.append(path + '.rotate')
+        # second pass so a rename never lands on a log not yet moved
+        for n, path in enumerate(staged, 1):
+            os.replace(path, LOG_DIR + '{}{}.log'.format(name, n))
+
+
+def lock_memory():
+    # keep the kick path resident under memory pressure. Called once start-up
+    # is done: only what is mapped now is locked, not later allocations, and
+    # the health worker is forked before and not locked at all
+    MCL_CURRENT = 1
+    try:
+        libc = ctypes.CDLL(None, use_errno=True)
+        return libc.mlockall(MCL_CURRENT) == 0
+    except (OSError, AttributeError):
+        return False
+
+
+def preload_health_check_imports():
+    # warm the modules the check imports without running it
+    try:
+        with open(HEALTH_CHECK) as f:
+            tree = ast.parse(f.read(), HEALTH_CHECK)
+    except (OSError, SyntaxError, ValueError):
+        return
+    sys.path.insert(0, os.path.dirname(HEALTH_CHECK))
+    for node in ast.walk(tree):
+        if isinstance(node, ast.Import):
+            names = [alias.name for alias in node.names]
+        elif isinstance(node, ast.ImportFrom) and node.level == 0 and node.module:
+            names = [node.module]
+        else:
+            continue
+        for name in names:
+            try:
+                __import__(name)
+            except Exception:
+                pass
+
+
+def run_health_check():
+    # in a forked child, returns its exit code
+    try:
+        runpy.run_path(HEALTH_CHECK, run_name='__main__')
+    except SystemExit as e:
+        if e.code is None:
+            return 0
+        return e.code if isinstance(e.code, int) and 0 <= e.code < 256 else 1
+    except Exception:
+        return 1
+    return 0
+
+
+def health_worker(req_fd, rsp_fd):
+    """
+    Health worker process: one fresh child per request byte, killed at the
+    deadline. Answers '<exit code or -1 on timeout> <msecs>'.
+    """
+    signal.signal(signal.SIGTERM, signal.SIG_DFL)
+    preload_health_check_imports()
+    while True:
+        if not os.read(req_fd, 1):
+            # supervisor gone
+            os._exit(0)
+        start = time.monotonic()
+        pid = os.fork()
+        if pid == 0:
+            code = run_health_check()
+            sys.stdout.flush()
+            sys.stderr.flush()
+            os._exit(code)
+        result = -1
+        while time.monotonic() - start < HEALTH_CHECK_DEADLINE_SECS:
+            wpid, status = os.waitpid(pid, os.WNOHANG)
+            if wpid == pid:
+                result = os.waitstatus_to_exitcode(status)
+                result = result if result >= 0 else 1
+                break
+            time.sleep(0.01)
+        else:
+            os.kill(pid, signal.SIGKILL)
+            os.waitpid(pid, 0)
+        os.write(rsp_fd, '{} {}\n'.format(result, int((time.monotonic() - start) * 1000)).encode())
+
+
+def health_monitor_disabled():
+    platform = None
+    try:
+        with open(MACHINE_CONF) as f:
+            for line in f:
+                k, _, v = line.rstrip('\n').partition('=')
+                if k == 'onie_platform':
+                    platform = v
+        with open(PLATFORM_NDK_JSON.format(platform)) as f:
+            options = json.load(f).get('options', [])
+    except (OSError, ValueError):
+        return False
+    for option in options:
+        if option.get('key') == 'disable_watchdog_hm':
+            return str(option.get('intval')) == '1'
+    return False
+
+
+class WatchdogSupervisor():
+    def __init__(self, init_log):
+        self.init_log = init_log
+        self.fd = None
+        self.notifier = SystemdNotifier()
+        self.hm_disabled = health_monitor_disabled()
+        self.app_count = 0
+        self.kicks = 0
+        self.missed_kicks = 0
+        self.start_date = utc_date()
+        self.jitter = LatencyStats(JITTER_BOUNDS_MS)
+        self.health = LatencyStats(tuple(b * 10 for b in JITTER_BOUNDS_MS))
+        self.health_failures = 0
+        self.health_timeouts = 0
+        self.health_pid = None
+        self.health_req = None
+        self.health_rsp = None
+        self.last_kick = None
+        self.max_gap = 0.0
+        self.late_kicks = 0
+        self.kick_errors = 0
+        self.arm_deadline = None
+
+    def log_init(self, msg):
+        self.init_log.write('{} at {}\n'.format(msg, utc_date()))
+        self.init_log.flush()
+
+    def run_init_cmd(self, cmd):
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        self.init_log.write(proc.stdout.decode(errors='replace'))
+        self.init_log.flush()
+        return proc.returncode
+
+    def open_watchdog(self):
+        # check for and remove sp5100 driver just in case blacklist somehow not present
+        self.run_init_cmd(['modprobe', '-v', '-r', 'sp5100_tco'])
+        self.run_init_cmd(['depmod', '-A'])
+        boot_prof_event('begin', 'module_load', WATCHDOG_MODULE)
+        self.log_init('before modprobe {}'.format(WATCHDOG_MODULE))
+        while self.run_init_cmd(['modprobe', '-v', WATCHDOG_MODULE]) != 0:
+            time.sleep(1)
+        self.log_init('after modprobe {}'.format(WATCHDOG_MODULE))
+        boot_prof_event('end', 'module_load', WATCHDOG_MODULE)
+
+        boot_prof_event('begin', 'sysfs_ready', WATCHDOG_DEV)
+        while not os.path.exists(WATCHDOG_DEV):
+            time.sleep(0.1)
+        boot_prof_event('end', 'sysfs_ready', WATCHDOG_DEV)
+        self.fd = os.open(WATCHDOG_DEV, os.O_WRONLY | os.O_CLOEXEC)
+        if self.kick(time.monotonic()):
+            self.log_init('first kick done using fd {}'.format(self.fd))
+        else:
+            self.log_init('first kick failed using fd {}, retried next period'.format(self.fd))
+        boot_prof_event('mark', 'first_kick')
+        os.sync()
+        self.log_init('sync done')
+
+    def start_health_worker(self):
+        """
+        Forks the health worker, at start before the watchdog is opened and
+        memory locked. A worker re-forked later closes the inherited
+        watchdog fd, or a dead supervisor's replacement could not reopen it.
+        """
+        if self.hm_disabled or not os.path.exists(HEALTH_CHECK):
+            return
+        req_r, req_w = os.pipe()
+        rsp_r, rsp_w = os.pipe()
+        pid = os.fork()
+        if pid == 0:
+            os.close(req_w)
+            os.close(rsp_r)
+            if self.fd is not None:
+                os.close(self.fd)
+            try:
+                health_worker(req_r, rsp_w)
+            finally:
+                os._exit(1)
+        os.close(req_r)
+        os.close(rsp_w)
+        self.health_pid = pid
+        self.health_req = req_w
+        self.health_rsp = os.fdopen(rsp_r, 'r')
+        self.log_init('health worker started pid {}'.format(pid))
+
+    def stop_health_worker(self):
+        if self.health_pid is None:
+            return
+        try:
+            os.kill(self.health_pid, signal.SIGKILL)
+            os.waitpid(self.health_pid, 0)
+        except OSError:
+            pass
+        os.close(self.health_req)
+        self.health_rsp.close()
+        self.health_pid = None
+
+    def check_health(self):
+        """
+        Returns True when healthy. A check that misses its deadline is killed
+        by the worker and counted as a failure.
+        """
+        if not os.path.exists(HEALTH_CHECK):
+            return True
+        if self.health_pid is None:
+            self.start_health_worker()
+            if self.health_pid is None:
+                return True
+        try:
+            os.write(self.health_req, b'c')
+            ready, _, _ = select.select([self.health_rsp], [], [], HEALTH_CHECK_DEADLINE_SECS + 1)
+            line = self.health_rsp.readline() if ready else ''
+            result, msecs = (int(v) for v in line.split())
+        except (OSError, ValueError):
+            # worker died or hung, a new one is forked for the next check
+            self.log_init('health worker {} failed, restarting'.format(self.health_pid))
+            self.stop_health_worker()
+            self.health_timeouts += 1
+            return False
+        self.health.record(msecs)
+        if result < 0:
+            self.health_timeouts += 1
+            return False
+        if result != 0:
+            self.health_failures += 1
+            return False
+        return True
+
+    def read_arm_deadline(self):
+        try:
+            with open(WD_ARM_FILE) as f:
+                return float(json.load(f)['deadline'])
+        except (OSError, ValueError, KeyError, TypeError):
+            return None
+
+    def kick(self, now):
+        """
+        Returns True if kicked. A failed kick, e.g. the driver's KICK method
+        failing, is a missed kick retried next period.
+        """
+        try:
+            os.write(self.fd, b'w')
+        except OSError as e:
+            self.kick_errors += 1
+            self.missed_kicks += 1
+            self.log_init('watchdog kick failed: {}'.format(e))
+            return False
+        if self.last_kick is not None:
+            gap = now - self.last_kick
+            self.max_gap = max(self.max_gap, gap)
+            if gap > WATCHDOG_KICK_SECS + WATCHDOG_LATE_SECS:
+                self.late_kicks += 1
+        self.last_kick = now
+        self.kicks += 1
+        return True
+
+    def write_status_file(self, healthy):
+        status = {'pid': os.getpid(), 'period': WATCHDOG_KICK_SECS, 'late_secs': WATCHDOG_LATE_SECS,
+                  'updated': time.monotonic(), 'last_kick': self.last_kick, 'kicks': self.kicks,
+                  'missed_kicks': self.missed_kicks, 'max_gap': round(self.max_gap, 3),
+                  'late_kicks': self.late_kicks, 'kick_errors': self.kick_errors, 'healthy': healthy, 'arm_deadline': self.arm_deadline}
+        try:
+            with open(WD_STATUS_FILE + '.tmp', 'w') as f:
+                json.dump(status, f)
+            os.replace(WD_STATUS_FILE + '.tmp', WD_STATUS_FILE)
+        except OSError:
+            pass
+
+    def write_status(self, healthy):
+        status = 'kicks {} missed {} errors {} jitter [{}] health [{}] failures {} timeouts {}'.format(
+            self.kicks, self.missed_kicks, self.kick_errors, self.jitter, self.health, self.health_failures, self.health_timeouts)
+        with open(WD_LOG, 'w') as f:
+            f.write('{}\n{}\n{}\n'.format(self.start_date, utc_date(), status))
+            if not healthy and self.app_count >= MIN_APP_COUNT_FAILURES:
+                f.write('platform process health monitor failed, missed {} watchdog kick. '
+                        'System will reboot soon.\n'.format(self.app_count - MIN_APP_COUNT_FAILURES))
+            elif not healthy:
+                f.write('armed watchdog expired, missed {} watchdog kick. '
+                        'System will reboot soon.\n'.format(self.missed_kicks))
+        self.notifier.notify('STATUS={}'.format(status))
+
+    def run(self):
+        if self.hm_disabled:
+            self.log_init('Watchdog platform-ndk health-monitoring is disabled')
+        else:
+            self.log_init('Watchdog platform-ndk health-monitoring is enabled')
+        self.notifier.notify('READY=1')
+
+        skip_hm_kicks = WATCHDOG_SKIP_HM_KICKS
+        next_kick = time.monotonic()
+        while True:
+            healthy = True
+            if skip_hm_kicks > 0:
+                self.log_init('Skipping platform_ndk health monitor check for {}'.format(skip_hm_kicks))
+                skip_hm_kicks -= 1
+            elif not self.hm_disabled:
+                if self.check_health():
+                    self.app_count = 0
+                else:
+                    self.app_count += 1
+                healthy = self.app_count < MIN_APP_COUNT_FAILURES
+
+            # the health check may have used part of the period, kick on schedule
+            delay = next_kick - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            now = time.monotonic()
+            arm_deadline = self.read_arm_deadline()
+            if arm_deadline != self.arm_deadline:
+                self.log_init('Watchdog {}'.format('disarmed' if arm_deadline is None else
+                              'armed, kicks stop in {:.0f}s'.format(arm_deadline - now)))
+                self.arm_deadline = arm_deadline
+            if arm_deadline is not None and now >= arm_deadline:
+                # armed through the platform API and not re-armed in time
+                healthy = False
+            if healthy:
+                if self.kick(now):
+                    self.jitter.record((now - next_kick) * 1000)
+            else:
+                self.missed_kicks += 1
+            # the service itself is alive either way
+            self.notifier.notify('WATCHDOG=1')
+            self.write_status(healthy)
+            self.write_status_file(healthy)
+
+            next_kick += WATCHDOG_KICK_SECS
+            if next_kick < now:
+                # suspended or badly starved, restart the schedule
+                next_kick = now + WATCHDOG_KICK_SECS
+
+
+def main():
+    rotate_logs()
+    with open(WD_INIT_LOG, 'w') as init_log:
+        init_log.write('Started at {}\n'.format(utc_date()))
+        init_log.flush()
+        supervisor = WatchdogSupervisor(init_log)
+        supervisor.start_health_worker()
+        supervisor.open_watchdog()
+        if not lock_memory():
+            supervisor.log_init('mlockall failed')
+        supervisor.run()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -2,6 +2,11 @@
 
 #platform init script for Nokia IXR7220 H3
 
+# boot_prof_* phase timestamps, no-ops unless boot profiling is enabled
+source /usr/local/bin/nokia-boot-profile.sh
+# i2c_new_mux / i2c_new_device / i2c_instantiate_devices
+source /usr/local/bin/nokia-i2c-devices.sh
+
 # Load required kernel-mode drivers
 load_kernel_drivers() {
     echo "Loading Kernel Drivers"  
@@ -45,106 +50,122 @@ file_exists() {
  }
 
  # Install kernel drivers required for i2c bus access
+boot_prof_begin module_load
 load_kernel_drivers
+boot_prof_end module_load
+
+# Muxes are created one at a time in this order, their channels get the
+# bus numbers used below and by the platform code. Leaf devices are only
+# queued and created concurrently once all muxes are up.
+failed=0
 
-file_exists /sys/bus/i2c/devices/i2c-0/new_device
 # Enumerate I2C Multiplexer
-echo pca9548 0x77 > /sys/bus/i2c/devices/i2c-0/new_device
+i2c_new_mux i2c-0 pca9548 0x77 2 || failed=$((failed + 1))
 
 # Enumerate system eeprom
-echo 24c02 0x53 > /sys/bus/i2c/devices/i2c-0/new_device
+i2c_new_device i2c-0 24c02 0x53
 
 #file_exists /sys/bus/i2c/devices/i2c-2/new_device
 # Enumerate I2C Multiplexer
-echo pca9548 0x70 > /sys/bus/i2c/devices/i2c-2/new_device
+i2c_new_mux i2c-2 pca9548 0x70 10 || failed=$((failed + 1))
 
 #file_exists /sys/bus/i2c/devices/i2c-3/new_device
 # Enumerate I2C Multiplexer
-echo pca9548 0x70 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_mux i2c-3 pca9548 0x70 18 || failed=$((failed + 1))
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x71 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_mux i2c-3 pca9548 0x71 26 || failed=$((failed + 1))
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x72 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_mux i2c-3 pca9548 0x72 34 || failed=$((failed + 1))
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x73 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_mux i2c-3 pca9548 0x73 42 || failed=$((failed + 1))
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x74 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_mux i2c-3 pca9548 0x74 50 || failed=$((failed + 1))
 
 # Enumerate PSU1 
-echo dps_1600ab_29_a  0x58 > /sys/bus/i2c/devices/i2c-10/new_device
+i2c_new_device i2c-10 dps_1600ab_29_a 0x58
 # Enumerate PSU2
-echo dps_1600ab_29_a  0x58 > /sys/bus/i2c/devices/i2c-11/new_device
+i2c_new_device i2c-11 dps_1600ab_29_a 0x58
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x75 > /sys/bus/i2c/devices/i2c-12/new_device
+i2c_new_mux i2c-12 pca9548 0x75 58 || failed=$((failed + 1))
 
 # Enumerate Fan SPD controller
-echo emc2305 0x2e > /sys/bus/i2c/devices/i2c-13/new_device
+i2c_new_device i2c-13 emc2305 0x2e
 
 # Enumerate Fan SPD controller
-echo emc2305 0x4c > /sys/bus/i2c/devices/i2c-13/new_device
+i2c_new_device i2c-13 emc2305 0x4c
 
 # Enumerate Fan SPD controller
-echo emc2305 0x2d > /sys/bus/i2c/devices/i2c-13/new_device
+i2c_new_device i2c-13 emc2305 0x2d
 
 # Enumerate PCA9555(GPIO Mux)
-echo pca9555 0x27 > /sys/bus/i2c/devices/i2c-64/new_device
+i2c_new_device i2c-64 pca9555 0x27
 
 # Enumerate Thermal Sensor (FANBD)
-echo tmp75 0x4f > /sys/bus/i2c/devices/i2c-13/new_device
+i2c_new_device i2c-13 tmp75 0x4f
 
 # Enumerate Thermal Sensor (RF)
-echo tmp75 0x4b > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 tmp75 0x4b
 
 # Enumerate Thermal Sensor (LF)
-echo tmp75 0x49 > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 tmp75 0x49
 
 # Enumerate Thermal Sensor (UPPER MAC)
-echo tmp75 0x4a > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 tmp75 0x4a
 
 # Enumerate Thermal Sensor (LOWER MAC)
-echo tmp75 0x4e > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 tmp75 0x4e
 
 # Enumerate Thermal Sensor (CPU)
-echo tmp75 0x4d > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 tmp75 0x4d
 
 # Enumerate Voltage Ragulator (0V8)
-echo tps53647 0x65 > /sys/bus/i2c/devices/i2c-15/new_device
+i2c_new_device i2c-15 tps53647 0x65
 
 # Enumerate Voltage Ragulator (0V9)
-echo ir35221 0x10 > /sys/bus/i2c/devices/i2c-15/new_device
+i2c_new_device i2c-15 ir35221 0x10
 
 # Enumerate Voltage Ragulator (3V3)
-echo tps53667 0x64 > /sys/bus/i2c/devices/i2c-15/new_device
+i2c_new_device i2c-15 tps53667 0x64
 
 #Enumerate CPLDs
-echo nokia_7220h3_cpupld 0x31 > /sys/bus/i2c/devices/i2c-0/new_device
-echo nokia_7220h3_swpld1 0x32 > /sys/bus/i2c/devices/i2c-17/new_device
-echo nokia_7220h3_swpld2 0x34 > /sys/bus/i2c/devices/i2c-17/new_device
-echo nokia_7220h3_swpld3 0x35 > /sys/bus/i2c/devices/i2c-17/new_device
+i2c_new_device i2c-0 nokia_7220h3_cpupld 0x31
+i2c_new_device i2c-17 nokia_7220h3_swpld1 0x32
+i2c_new_device i2c-17 nokia_7220h3_swpld2 0x34
+i2c_new_device i2c-17 nokia_7220h3_swpld3 0x35
 
 # Enumerate the QSFP-DD devices on each mux channel
 for chan in {18..49}
 do
-    echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-${chan}/new_device
+    i2c_new_device i2c-${chan} optoe1 0x50
 done
 
 # Enumerate the SFP+ devices on each mux channel
-echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-50/new_device
-echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-51/new_device
+i2c_new_device i2c-50 optoe1 0x50
+i2c_new_device i2c-51 optoe1 0x50
 
 # Enumerate Fans(0-5) eeprom
 for chan in {0..5}
 do
-    echo 24c02 0x50 > /sys/bus/i2c/devices/12-0075/channel-${chan}/new_device
+    i2c_new_device 12-0075/channel-${chan} 24c02 0x50
 done
 
+boot_prof_begin i2c_instantiate
+i2c_instantiate_devices
+failed=$((failed + $?))
+boot_prof_end i2c_instantiate
+if [ $failed -ne 0 ]; then
+    echo "$failed i2c muxes or devices failed"
+fi
+
+boot_prof_begin sysfs_ready 0-0053/eeprom
 file_exists /sys/bus/i2c/devices/0-0053/eeprom
 status=$?
+boot_prof_end sysfs_ready 0-0053/eeprom
 if [ "$status" == "1" ]; then
     chmod 644 /sys/bus/i2c/devices/0-0053/eeprom
 else
@@ -172,4 +193,6 @@ echo -2 > /sys/bus/i2c/devices/3-0072/idle_state
 echo -2 > /sys/bus/i2c/devices/3-0073/idle_state
 echo -2 > /sys/bus/i2c/devices/3-0074/idle_state
 
+boot_prof_mark done
+boot_prof_first_read first_sensor_read "/sys/bus/i2c/devices/13-004f/hwmon/hwmon*/temp1_input"
 exit 0
@@ -2,6 +2,11 @@
 
 #platform init script for Nokia-IXR7220-H4-32D
 
+# boot_prof_* phase timestamps, no-ops unless boot profiling is enabled
+source /usr/local/bin/nokia-boot-profile.sh
+# i2c_new_mux / i2c_new_device / i2c_instantiate_devices
+source /usr/local/bin/nokia-i2c-devices.sh
+
 # Load required kernel-mode drivers
 load_kernel_drivers() {
     echo "Loading Kernel Drivers"  
@@ -47,70 +52,86 @@ file_exists() {
  }
 
  # Install kernel drivers required for i2c bus access
+boot_prof_begin module_load
 load_kernel_drivers
+boot_prof_end module_load
+
+# Muxes are created one at a time in this order, their channels get the
+# bus numbers used below and by the platform code. Leaf devices are only
+# queued and created concurrently once all muxes are up.
+failed=0
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x70 > /sys/bus/i2c/devices/i2c-0/new_device
+i2c_new_mux i2c-0 pca9548 0x70 || failed=$((failed + 1))
 
 #Enumerate I2C Multiplexers
-echo pca9548 0x70 > /sys/bus/i2c/devices/i2c-10/new_device 
-echo pca9548 0x71 > /sys/bus/i2c/devices/i2c-11/new_device 
-echo pca9548 0x72 > /sys/bus/i2c/devices/i2c-12/new_device 
-echo pca9548 0x73 > /sys/bus/i2c/devices/i2c-13/new_device 
+i2c_new_mux i2c-10 pca9548 0x70 23 || failed=$((failed + 1))
+i2c_new_mux i2c-11 pca9548 0x71 31 || failed=$((failed + 1))
+i2c_new_mux i2c-12 pca9548 0x72 39 || failed=$((failed + 1))
+i2c_new_mux i2c-13 pca9548 0x73 47 || failed=$((failed + 1))
 
 #Enumerate CPLDs
-echo h4_32d_cpupld 0x31 > /sys/bus/i2c/devices/i2c-0/new_device
+i2c_new_device i2c-0 h4_32d_cpupld 0x31
 
 # Enumerate system eeprom
-echo 24c02 0x53 > /sys/bus/i2c/devices/i2c-0/new_device
+i2c_new_device i2c-0 24c02 0x53
 
 # Enumerate I2C Multiplexer
-echo pca9548 0x75 > /sys/bus/i2c/devices/i2c-4/new_devicee
+i2c_new_mux i2c-4 pca9548 0x75 57 || failed=$((failed + 1))
 
 # Enumerate PSU 
-echo dps_1600ab_29_a  0x58 > /sys/bus/i2c/devices/i2c-2/new_device
-echo dps_1600ab_29_a  0x58 > /sys/bus/i2c/devices/i2c-3/new_device
+i2c_new_device i2c-2 dps_1600ab_29_a 0x58
+i2c_new_device i2c-3 dps_1600ab_29_a 0x58
 
 # Enumerate Fan SPD controller
-echo emc2305 0x4c > /sys/bus/i2c/devices/i2c-5/new_device
-echo emc2305 0x2d > /sys/bus/i2c/devices/i2c-5/new_device
-echo emc2305 0x2e > /sys/bus/i2c/devices/i2c-5/new_device
+i2c_new_device i2c-5 emc2305 0x4c
+i2c_new_device i2c-5 emc2305 0x2d
+i2c_new_device i2c-5 emc2305 0x2e
 
 # Enumerate Thermal Sensor 
-echo tmp75 0x4f > /sys/bus/i2c/devices/i2c-5/new_device
-echo tmp75 0x4b > /sys/bus/i2c/devices/i2c-6/new_device
-echo tmp75 0x49 > /sys/bus/i2c/devices/i2c-6/new_device
-echo tmp75 0x4a > /sys/bus/i2c/devices/i2c-6/new_device
-echo tmp75 0x4e > /sys/bus/i2c/devices/i2c-6/new_device
-echo tmp75 0x4d > /sys/bus/i2c/devices/i2c-6/new_device
+i2c_new_device i2c-5 tmp75 0x4f
+i2c_new_device i2c-6 tmp75 0x4b
+i2c_new_device i2c-6 tmp75 0x49
+i2c_new_device i2c-6 tmp75 0x4a
+i2c_new_device i2c-6 tmp75 0x4e
+i2c_new_device i2c-6 tmp75 0x4d
 
 # Enumerate Voltage Ragulator
-echo isl68239 0x65 > /sys/bus/i2c/devices/i2c-7/new_device
-echo isl68239 0x63 > /sys/bus/i2c/devices/i2c-7/new_device
-echo isl68239 0x64 > /sys/bus/i2c/devices/i2c-7/new_device
+i2c_new_device i2c-7 isl68239 0x65
+i2c_new_device i2c-7 isl68239 0x63
+i2c_new_device i2c-7 isl68239 0x64
 
 # Enumerate PCA9555(GPIO Mux)
-echo pca9555 0x27 > /sys/bus/i2c/devices/i2c-22/new_device
+i2c_new_device i2c-22 pca9555 0x27
 
 #Enumerate PortPLDs
-echo h4_32d_swpld2 0x34 > /sys/bus/i2c/devices/i2c-9/new_device
-echo h4_32d_swpld3 0x35 > /sys/bus/i2c/devices/i2c-9/new_device
+i2c_new_device i2c-9 h4_32d_swpld2 0x34
+i2c_new_device i2c-9 h4_32d_swpld3 0x35
 
 #Enumerate QSFPs and SFPs
-echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-14/new_device
+i2c_new_device i2c-14 optoe1 0x50
 for qsfpnum in {23..54}; do
-	echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-${qsfpnum}/new_device
-	sleep 0.1
+	i2c_new_device i2c-${qsfpnum} optoe1 0x50
 done
 
 # Enumerate Fans(0-5) eeprom
 for chan in {0..6}
 do
-    echo 24c02 0x50 > /sys/bus/i2c/devices/4-0075/channel-${chan}/new_device
+    i2c_new_device 4-0075/channel-${chan} 24c02 0x50
 done
 
+boot_prof_begin i2c_instantiate
+i2c_instantiate_devices
+failed=$((failed + $?))
+boot_prof_end i2c_instantiate
+if [ $failed -ne 0 ]; then
+    echo "$failed i2c muxes or devices failed"
+fi
+
+boot_prof_begin sysfs_ready 1-0053/eeprom
 file_exists /sys/bus/i2c/devices/1-0053/eeprom
 status=$?
+boot_prof_end sysfs_ready 1-0053/eeprom
 if [ "$status" == "1" ]; then
     chmod 644 /sys/bus/i2c/devices/1-0053/eeprom
     h4_32d_profile
@@ -129,4 +150,6 @@ do
     chmod 644 /sys/bus/i2c/devices/${fan}-0050/eeprom
 done
 
+boot_prof_mark done
+boot_prof_first_read first_sensor_read "/sys/bus/i2c/devices/5-004f/hwmon/hwmon*/temp1_input"
 exit 0
@@ -2,6 +2,11 @@
 
 #platform init script for Nokia-IXR7220-H5-64D
 
+# boot_prof_* phase timestamps, no-ops unless boot profiling is enabled
+source /usr/local/bin/nokia-boot-profile.sh
+# i2c_new_mux / i2c_new_device / i2c_instantiate_devices
+source /usr/local/bin/nokia-i2c-devices.sh
+
 # Load required kernel-mode drivers
 load_kernel_drivers() {
     echo "Loading Kernel Drivers"  
@@ -47,27 +52,38 @@ file_exists() {
  }
 
  # Install kernel drivers required for i2c bus access
+boot_prof_begin module_load
 load_kernel_drivers
+boot_prof_end module_load
 
 #insmod /lib/modules/6.1.0-11-2-amd64/delta_fpga.ko
 
 #Enumerate I2C Multiplexers
-echo pca9548 0x71 > /sys/bus/i2c/devices/i2c-3/new_device
+# muxes are created one at a time in this order, their channels get the
+# bus numbers used below and by the platform code (i2c-12,13 and 20..83)
+failed=0
+i2c_new_mux i2c-3 pca9548 0x71 12 || failed=$((failed + 1))
 for devnum in {4..11}; do
-    echo pca9548 0x70 > /sys/bus/i2c/devices/i2c-${devnum}/new_device 
-    sleep 0.1
+    i2c_new_mux i2c-${devnum} pca9548 0x70 $((20 + (devnum - 4) * 8)) || failed=$((failed + 1))
 done
 
 #Enumerate CPLDs
-echo h5_portpld1 0x41 > /sys/bus/i2c/devices/i2c-2/new_device
-echo h5_portpld2 0x45 > /sys/bus/i2c/devices/i2c-2/new_device
+i2c_new_device i2c-2 h5_portpld1 0x41
+i2c_new_device i2c-2 h5_portpld2 0x45
 
 #Enumerate QSFPs and SFPs
-echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-12/new_device
-echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-13/new_device
+i2c_new_device i2c-12 optoe1 0x50
+i2c_new_device i2c-13 optoe1 0x50
 for qsfpnum in {20..83}; do
-	echo optoe1 0x50 > /sys/bus/i2c/devices/i2c-${qsfpnum}/new_device
-	sleep 0.1
+	i2c_new_device i2c-${qsfpnum} optoe1 0x50
 done
+boot_prof_begin i2c_instantiate
+i2c_instantiate_devices
+failed=$((failed + $?))
+boot_prof_end i2c_instantiate
+if [ $failed -ne 0 ]; then
+    echo "$failed i2c muxes or devices failed"
+fi
 
+boot_prof_mark done
 exit 0
@@ -11,8 +11,8 @@ try:
     import os
     import time
     import glob
+    import json
     import struct
-    from os import *
     from mmap import *
     from sonic_platform_base.fan_base import FanBase
     from sonic_platform.eeprom import Eeprom
@@ -44,9 +44,155 @@ RESOURCE = "/sys/bus/pci/devices/0000:02:00.0/resource0"
 REG_FAN_LED = 0x00A0
 INDEX_FAN_LED = [0, 4, 8, 12]
 
+# PWM-to-RPM curves measured by calibrate_fans() (nokia-fan-calibrate.py
+# on the host), keyed by fan name and only used while the fan drawer's
+# serial number matches. Calibrated fans are set with full PWM resolution
+# and their speeds are percentages of the curve's RPM at full PWM.
+FAN_CALIBRATION_FILE = '/etc/sonic/nokia_fan_calibration.json'
+FAN_CALIBRATION_VERSION = 1
+FAN_CALIBRATION_PWM = [255, 224, 192, 160, 128, 96, 80, 64, 48, 32, 16, 0]
+FAN_CALIBRATION_SETTLE_SECS = 6
+FAN_CALIBRATION_SAMPLES = 3
+FAN_MAX_PWM = 255
+
 sonic_logger = logger.Logger('fan')
 
 
+class FanCalibrationAborted(Exception):
+    """
+    A thermal went above its high threshold during calibrate_fans()
+    """
+    pass
+
+# file mtime and contents, re-read when the file changes
+_calibration = {'mtime': None, 'fans': {}}
+
+
+def load_calibration():
+    try:
+        mtime = os.stat(FAN_CALIBRATION_FILE).st_mtime_ns
+    except OSError:
+        _calibration['mtime'] = None
+        _calibration['fans'] = {}
+        return _calibration['fans']
+
+    if mtime != _calibration['mtime']:
+        _calibration['mtime'] = mtime
+        _calibration['fans'] = {}
+        try:
+            with open(FAN_CALIBRATION_FILE, 'r') as f:
+                data = json.load(f)
+            if data.get('version') == FAN_CALIBRATION_VERSION:
+                _calibration['fans'] = data.get('fans', {})
+        except (OSError, ValueError) as e:
+            sonic_logger.log_warning("Unable to read {}: {}".format(FAN_CALIBRATION_FILE, e))
+    return _calibration['fans']
+
+
+def _interpolate(x, x0, y0, x1, y1):
+    if x1 == x0:
+        return y1
+    return y0 + (y1 - y0) * (x - x0) / (x1 - x0)
+
+
+def _check_thermals(thermals):
+    for thermal in thermals:
+        try:
+            temperature = thermal.get_temperature()
+            high_threshold = thermal.get_high_threshold()
+        except Exception:
+            # e.g. the ASIC temperature is not in STATE_DB yet
+            continue
+        if temperature is not None and high_threshold is not None and temperature > high_threshold:
+            raise FanCalibrationAborted("{} at {}C, above its {}C high threshold".format(
+                thermal.get_name(), temperature, high_threshold))
+
+
+def _calibration_sleep(secs, thermals):
+    # the thermals are watched every second while the fans slow down
+    end = time.monotonic() + secs
+    while True:
+        _check_thermals(thermals)
+        remaining = end - time.monotonic()
+        if remaining <= 0:
+            return
+        time.sleep(min(1.0, remaining))
+
+
+def _sweep_fans(fans, settle_secs, thermals):
+    points = dict((fan, []) for fan in fans)
+    for pwm in FAN_CALIBRATION_PWM:
+        for fan in fans:
+            fan._write_sysfs_file(fan.set_fan_speed_reg, str(pwm))
+        _calibration_sleep(settle_secs, thermals)
+
+        rpms = dict((fan, 0) for fan in fans)
+        for sample in range(FAN_CALIBRATION_SAMPLES):
+            for fan in fans:
+                rpm = fan._read_sysfs_file(fan.get_fan_speed_reg)
+                rpms[fan] += int(rpm) if rpm != 'ERR' else 0
+            _calibration_sleep(0.5, thermals)
+        for fan in fans:
+            points[fan].append([pwm, rpms[fan] // FAN_CALIBRATION_SAMPLES])
+    return points
+
+
+def calibrate_fans(fans, settle_secs=FAN_CALIBRATION_SETTLE_SECS, thermals=()):
+    """
+    Sweeps the PWM of the present fans from full speed down, one fan
+    drawer at a time with the others at full speed, and stores each fan's
+    measured PWM-to-RPM curve in FAN_CALIBRATION_FILE. The thermal control
+    must not drive the fans meanwhile. The fans' PWM is restored when
+    done; if a thermal goes above its high threshold the sweep stops, all
+    fans are left at full speed and nothing is stored.
+    :param fans: Fan objects, PSU fans are skipped
+    :param thermals: Thermal objects watched during the sweep
+    :return: dict of fan name to its calibration
+    """
+    fans = [fan for fan in fans if not fan.is_psu_fan and fan.get_presence()]
+    saved_pwm = dict((fan, fan._read_sysfs_file(fan.set_fan_speed_reg)) for fan in fans)
+    points = {}
+    drawers = {}
+    for fan in fans:
+        if fan.get_serial() in ('', 'NA'):
+            # could never be matched to its drawer again
+            sonic_logger.log_warning("{} has no serial number, not calibrated".format(fan.get_name()))
+            continue
+        drawers.setdefault(fan.fan_drawer, []).append(fan)
+
+    completed = False
+    try:
+        for drawer, drawer_fans in sorted(drawers.items()):
+            for fan in fans:
+                if fan.fan_drawer != drawer:
+                    fan._write_sysfs_file(fan.set_fan_speed_reg, str(FAN_MAX_PWM))
+            points.update(_sweep_fans(drawer_fans, settle_secs, thermals))
+        completed = True
+    finally:
+        for fan, pwm in saved_pwm.items():
+            if not completed:
+                # too hot or interrupted, cooling first
+                fan._write_sysfs_file(fan.set_fan_speed_reg, str(FAN_MAX_PWM))
+            elif pwm != 'ERR':
+                fan._write_sysfs_file(fan.set_fan_speed_reg, pwm)
+
+    calibration = {}
+    for fan in points:
+        curve = sorted(points[fan])
+        calibration[fan.get_name()] = {'serial': fan.get_serial(), 'model': fan.get_model(),
+                                       'max_rpm': curve[-1][1], 'points': curve,
+                                       'date': time.strftime('%Y-%m-%d %H:%M:%S')}
+        sonic_logger.log_notice("{} calibrated, {} rpm at full speed".format(fan.get_name(), curve[-1][1]))
+
+    data = {'version': FAN_CALIBRATION_VERSION, 'fans': dict(load_calibration())}
+    data['fans'].update(calibration)
+    tmp_file = FAN_CALIBRATION_FILE + '.tmp'
+    with open(tmp_file, 'w') as f:
+        json.dump(data, f, indent=2)
+    os.replace(tmp_file, FAN_CALIBRATION_FILE)
+    return calibration
+
+
 class Fan(FanBase):
     """Nokia platform-specific Fan class"""
 
@@ -64,8 +210,9 @@ class Fan(FanBase):
             self.get_fan_speed_reg = hwmon_path[0] + "fan{}_input".format(fan_index_emc230x)
             self.gpio_dir = GPIO_DIR.format(GPIO_PORT[drawer_index])
            
-            # Fan eeprom
+            # Fan eeprom, re-read when the drawer is inserted again
             self.eeprom = Eeprom(False, 0, True, drawer_index)
+            self.eeprom_presence = self.get_presence()
 
             if fan_index == 0:
                 self.max_fan_speed = MAX_FAN_F_SPEED                    
@@ -108,32 +255,77 @@ class Fan(FanBase):
             rv = 'ERR'
 
         # Ensure that the write operation has succeeded
-        if (int(self._read_sysfs_file(sysfs_file)) != value ):
+        if (self._read_sysfs_file(sysfs_file) != str(value)):
             time.sleep(3)
-            if (int(self._read_sysfs_file(sysfs_file)) != value ):
+            if (self._read_sysfs_file(sysfs_file) != str(value)):
                 rv = 'ERR'
 
         return rv
     
     def pci_set_value(resource, data, offset):
-        fd = open(resource, O_RDWR)
+        fd = os.open(resource, os.O_RDWR)
         mm = mmap(fd, 0)
         mm.seek(offset)
         mm.write(struct.pack('I', data))
         mm.close()
-        close(fd)
+        os.close(fd)
 
     def pci_get_value(resource, offset):
-        fd = open(resource, O_RDWR)
+        fd = os.open(resource, os.O_RDWR)
         mm = mmap(fd, 0)
         mm.seek(offset)
         read_data_stream = mm.read(4)
         reg_val = struct.unpack('I', read_data_stream)
         mm.close()
-        close(fd)
+        os.close(fd)
         return reg_val
 
     
+    def _get_calibration(self):
+        """
+        Returns this fan's calibration as (points, max_rpm) with the RPM
+        made non-decreasing in PWM, or None if it is not calibrated
+        """
+        if self.is_psu_fan:
+            return None
+        calibration = load_calibration().get(self.get_name())
+        if calibration is None or calibration['max_rpm'] <= 0:
+            return None
+        serial = self.get_serial()
+        if serial in ('', 'NA') or calibration['serial'] != serial:
+            return None
+
+        points = []
+        rpm = 0
+        for pwm, measured in calibration['points']:
+            rpm = max(rpm, measured)
+            points.append((pwm, rpm))
+        return points, rpm
+
+    def _pwm_to_rpm(self, points, pwm):
+        for (pwm0, rpm0), (pwm1, rpm1) in zip(points, points[1:]):
+            if pwm <= pwm1:
+                return _interpolate(pwm, pwm0, rpm0, pwm1, rpm1)
+        return points[-1][1]
+
+    def _rpm_to_pwm(self, points, rpm):
+        """
+        Lowest PWM reaching rpm, at least the lowest PWM that spins the fan
+        unless rpm is 0
+        """
+        if rpm <= 0:
+            return 0
+        for (pwm0, rpm0), (pwm1, rpm1) in zip(points, points[1:]):
+            if rpm0 > 0 and rpm <= rpm0:
+                return pwm0
+            if rpm > rpm1:
+                continue
+            if rpm0 == 0:
+                # the fan stalls somewhere below pwm1
+                return pwm1
+            return int(round(_interpolate(rpm, rpm0, pwm0, rpm1, pwm1)))
+        return FAN_MAX_PWM
+
     def get_name(self):
         """
         Retrieves the name of the Fan
@@ -159,6 +351,13 @@ class Fan(FanBase):
         else:
             return False
 
+    def _refresh_eeprom(self):
+        # a replaced drawer has another serial number and part number
+        presence = self.get_presence()
+        if presence and not self.eeprom_presence:
+            self.eeprom._load_system_eeprom()
+        self.eeprom_presence = presence
+
     def get_model(self):
         """
         Retrieves the model number of the Fan
@@ -166,6 +365,7 @@ class Fan(FanBase):
         Returns:
             string: Model number of Fan. Use part number for this.
         """
+        self._refresh_eeprom()
         return self.eeprom.modelstr()
 
     def get_serial(self):
@@ -175,6 +375,7 @@ class Fan(FanBase):
         Returns:
             string: Serial number of Fan
         """
+        self._refresh_eeprom()
         return self.eeprom.serial_number_str()
 
     def get_part_number(self):
@@ -184,6 +385,7 @@ class Fan(FanBase):
         Returns:
             string: Part number of Fan
         """
+        self._refresh_eeprom()
         return self.eeprom.part_number_str()
 
     def get_service_tag(self):
@@ -193,6 +395,7 @@ class Fan(FanBase):
         Returns:
             string: Service Tag of Fan
         """
+        self._refresh_eeprom()
         return self.eeprom.service_tag_str()
 
     def get_status(self):
@@ -258,7 +461,11 @@ class Fan(FanBase):
         else:
             speed_in_rpm = 0
 
-        speed = 100*speed_in_rpm//self.max_fan_speed
+        calibration = self._get_calibration()
+        if calibration is not None:
+            speed = int(round(100.0*speed_in_rpm/calibration[1]))
+        else:
+            speed = 100*speed_in_rpm//self.max_fan_speed
         if speed > 100:
             speed = 100
 
@@ -287,7 +494,13 @@ class Fan(FanBase):
         if self.is_psu_fan:
             return False
 
-        if speed in range(0, 10):
+        calibration = self._get_calibration()
+        if calibration is not None:
+            if speed < 0 or speed > 100:
+                return False
+            points, max_rpm = calibration
+            fandutycycle = self._rpm_to_pwm(points, max_rpm * speed / 100.0)
+        elif speed in range(0, 10):
             fandutycycle = 0x00
         elif speed in range(10, 21):
             fandutycycle = 32
@@ -361,7 +574,11 @@ class Fan(FanBase):
         speed = 0
 
         fan_duty = self._read_sysfs_file(self.set_fan_speed_reg)
-        if (fan_duty != 'ERR'):
+        calibration = self._get_calibration()
+        if (fan_duty != 'ERR') and calibration is not None:
+            points, max_rpm = calibration
+            speed = int(round(100.0*self._pwm_to_rpm(points, int(fan_duty))/max_rpm))
+        elif (fan_duty != 'ERR'):
             dutyspeed = int(fan_duty)
             if dutyspeed == 0:
                 speed = 0